@@ -9,12 +9,62 @@
  */
 
 // To disable any component set value to 0
+#ifndef ENABLE_DEBUG
 #define ENABLE_DEBUG            0 //Enable Debugging
+#endif
 #define ENABLE_EASY_AUDIO       1 //Enable audio
 #define ENABLE_EASY_LED         1 //Enable LEDs
 #define ENABLE_EASY_OLED        1 //Enable OLED Display
 #define ENABLE_EASY_VOICE       1 //Enable Voice Recognition
 #define ENABLE_EASY_BUTTON      1 //Enable triggers
+// Cycle probes for the simavr benchmark in extras/avr_bench, keep at 0 on the prop
+#ifndef ENABLE_BENCH
+#define ENABLE_BENCH            0 //Enable cycle probes
+#endif
+// Timeline events on the debug port, needs ENABLE_DEBUG
+#ifndef ENABLE_TRACE
+#define ENABLE_TRACE            0 //Enable trace events
+#endif
+// Only the trigger, reload and voice input events, to replay a session on the host
+#ifndef ENABLE_RECORD
+#define ENABLE_RECORD           0 //Enable input recording
+#endif
+// Timer1 stage timings for the main loop, printed on request, needs ENABLE_DEBUG
+#ifndef ENABLE_PROFILE
+#define ENABLE_PROFILE          0 //Enable loop profiler
+#endif
+// Byte loss counters for the voice and audio links, printed on request, needs ENABLE_DEBUG
+#ifndef ENABLE_LINK_STATS
+#define ENABLE_LINK_STATS       0 //Enable serial link counters
+#endif
+// When each boot stage finished, printed on request, needs ENABLE_DEBUG
+#ifndef ENABLE_BOOT_TIMES
+#define ENABLE_BOOT_TIMES       0 //Enable boot stage timestamps
+#endif
+// Bring the screen up first and let the audio player boot behind the logo
+#ifndef ENABLE_FAST_BOOT
+#define ENABLE_FAST_BOOT        0 //Enable overlapped start up
+#endif
+// Send the main screen one page per pass of the main loop instead of all at once
+#ifndef ENABLE_OLED_PAGED
+#define ENABLE_OLED_PAGED       0 //Enable non-blocking screen updates
+#endif
+// OLED on the hardware SPI pins, needs the wiring below
+#ifndef ENABLE_OLED_HW_SPI
+#define ENABLE_OLED_HW_SPI      0 //Enable hardware SPI for the OLED
+#endif
+// Copy the screen text from easyoledlabelbits.h, which labelgen makes with the real fonts
+#ifndef ENABLE_OLED_LABELS
+#define ENABLE_OLED_LABELS      0 //Enable pre-rendered OLED labels
+#endif
+// Copy the battery and the grid from easyoledlabelbits.h instead of drawing them line by line
+#ifndef ENABLE_OLED_SHAPES
+#define ENABLE_OLED_SHAPES      0 //Enable pre-rendered OLED battery and grid
+#endif
+// Put the ammo counters together from the digit atlas in easyoledlabelbits.h
+#ifndef ENABLE_OLED_COUNTERS
+#define ENABLE_OLED_COUNTERS    0 //Enable the OLED counter atlas
+#endif
 
 
 // Customizable ID badge for DNA Check sequence 
@@ -38,16 +88,44 @@ const char DISPLAY_USER_ID[] PROGMEM =      {"Dredd"};
 #define RELOAD_PIN            9
 
 // Pin configuration for oled display
+#if ENABLE_OLED_HW_SPI == 1
+// SCL and SDA go to the SPI clock (SCK) and data (MOSI) pins, D12 (MISO) is
+// an input while SPI is on and stays free, reset sits on SS, which has to be
+// an output for SPI to work
+#define OLED_SCL_PIN          13
+#define OLED_SDA_PIN          11
+#define OLED_RESET_PIN        10
+#define OLED_DC_PIN           A4
+#define OLED_CS_PIN           A5
+#else
 #define OLED_SCL_PIN          A5
 #define OLED_SDA_PIN          A4
 #define OLED_RESET_PIN        10
 #define OLED_DC_PIN           11
 #define OLED_CS_PIN           12
+#endif
+
+// How EasyOLED talks to the display and how much of it U8g2 draws at a time,
+// see easyoledpolicy.h for the choices
+#ifndef OLED_TRANSPORT
+#if ENABLE_OLED_HW_SPI == 1
+#define OLED_TRANSPORT        OledHwSpi
+#else
+#define OLED_TRANSPORT        OledSwSpi
+#endif
+#endif
+#ifndef OLED_BUFFER
+#define OLED_BUFFER           OledPage2
+#endif
 
 
 // Pin configuration for front barrel WS2812B LED
 // set these to 0 if you want to disable the component
+#if ENABLE_OLED_HW_SPI == 1
+#define FIRE_LED_PIN          A0
+#else
 #define FIRE_LED_PIN          13
+#endif
 #define FIRE_LED_CNT          7
 
 
@@ -114,6 +192,9 @@ static const long  TIMING_STARTUP_ID_NAME_MS    =    1800L;
 static const long  TIMING_PROGRESS_INTERVAL_MS  =    100L;
 static const long  TIMING_LOW_AMMO_WAIT_MS      =    1000L;
 static const long  TIMING_FAST_BLINK_WAIT_MS    =    350L;
+static const long  TIMING_THEME_HOLD_MS         =    6000L;   // trigger held this long plays the theme
+// before asking the audio player again, a failed handshake has already waited a second for the reply
+static const long  TIMING_AUDIO_RETRY_MS        =    ENABLE_FAST_BOOT == 1 ? 250L : 3000L;
 
 
 /**
@@ -180,4 +261,93 @@ extern inline void DBGSTR(const __FlashStringHelper* message) {
 #endif
 }
 
+/**
+ * TRACE Macros
+ * Timeline events on the debug port, mixed in with the DBG output. Each one is
+ * a line of '~', B(egin), E(nd) or I(nstant), the event id, micros() and an
+ * optional argument:
+ *   ~B3 1234567
+ * extras/host_sim/tools/trace2json turns a captured log into a Chrome trace.
+ * Printing an event takes time too, about 1 ms per line at 115200 baud once
+ * the serial buffer is full.
+ *
+ * With ENABLE_RECORD only the input events are printed, which is what
+ * extras/host_sim/lawgiver_replay plays back.
+ */
+#define TRACE_MAIN_LOOP         1
+#define TRACE_OLED_DRAW         2
+#define TRACE_OLED_PAGE         3
+#define TRACE_LED_FRAME         4
+#define TRACE_AUDIO_TX          5
+#define TRACE_VOICE_POLL        6
+#define TRACE_BUTTON_DOWN       7 // argument is the pin
+#define TRACE_BUTTON_UP         8 // argument is the pin
+#define TRACE_VOICE_COMMAND     9 // argument is the record
+
+extern inline void TRACE_EVENT(char type, uint8_t id, int arg) {
+#if ENABLE_DEBUG == 1
+   unsigned long now = micros();
+   Serial.print('~');
+   Serial.print(type);
+   Serial.print(id);
+   Serial.print(' ');
+   if (arg < 0) {
+     Serial.println(now);
+   } else {
+     Serial.print(now);
+     Serial.print(' ');
+     Serial.println(arg);
+   }
+#endif
+}
+extern inline void TRACE_BEGIN(uint8_t id) {
+#if ENABLE_TRACE == 1
+   TRACE_EVENT('B', id, -1);
+#endif
+}
+extern inline void TRACE_END(uint8_t id) {
+#if ENABLE_TRACE == 1
+   TRACE_EVENT('E', id, -1);
+#endif
+}
+extern inline void TRACE_INPUT(uint8_t id, int arg) {
+#if ENABLE_TRACE == 1 || ENABLE_RECORD == 1
+   TRACE_EVENT('I', id, arg);
+#endif
+}
+
+/**
+ * BENCH Macros
+ * Marks the start and end of a section for the simavr benchmark. The probe id
+ * goes to GPIOR0, with the top bit set on the way out, which costs a single
+ * OUT instruction. The simulator watches the register and counts the cycles.
+ * Drawing a display mode uses BENCH_OLED_DRAW plus the mode.
+ * A mark is a begin and end in one, for a point in time rather than a section.
+ */
+#define BENCH_MAIN_LOOP         1
+#define BENCH_STARTUP           2
+#define BENCH_LED_UPDATE        3
+#define BENCH_AUDIO_PLAY        4
+#define BENCH_TRIGGER_PRESSED   5 // mark, checkTriggerSwitch() saw the press
+#define BENCH_AUDIO_TX          6 // mark, first byte of a DFPlayer Mini command is out
+#define BENCH_LED_SHOW          7 // mark, an ezPattern frame is shown
+#define BENCH_LED_CUT           8 // mark, a pattern was replaced before it finished
+#define BENCH_OLED_PAGE         9 // one page of a paged frame, the frame's end is a mark on BENCH_OLED_DRAW
+#define BENCH_OLED_DRAW         16
+
+extern inline void BENCH_BEGIN(uint8_t id) {
+#if ENABLE_BENCH == 1
+   GPIOR0 = id;
+#endif
+}
+extern inline void BENCH_END(uint8_t id) {
+#if ENABLE_BENCH == 1
+   GPIOR0 = id | 0x80;
+#endif
+}
+extern inline void BENCH_MARK(uint8_t id) {
+   BENCH_BEGIN(id);
+   BENCH_END(id);
+}
+
 #endif
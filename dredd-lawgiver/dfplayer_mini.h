@@ -2,6 +2,7 @@
 #define dfplayermini_h
 
 #include <Arduino.h>
+#include "easylinkstats.h"
 
 /**
  *  Namespace for constants
@@ -140,7 +141,9 @@ class DFPlayerMini {
    *  Send a config/command packet to the MP3 player.
    */
   void sendData() {
+    TRACE_BEGIN(TRACE_AUDIO_TX);
     _serial->write(sendStack.start_byte);
+    BENCH_MARK(BENCH_AUDIO_TX);
     _serial->write(sendStack.version);
     _serial->write(sendStack.length);
     _serial->write(sendStack.commandValue);
@@ -153,7 +156,9 @@ class DFPlayerMini {
     }
     _serial->write(sendStack.end_byte);
 
+    LINK_ACTIVITY(LINK_ACT_DELAY);
     delay(30);
+    TRACE_END(TRACE_AUDIO_TX);
 #if ENABLE_DEBUG == 1
     printStack(sendStack);
 #endif
@@ -187,7 +192,8 @@ class DFPlayerMini {
       DBGHEX(_stack.checksumLSB);
       DBGCH(' ');
     }
-    DBGLN(_stack.end_byte);
+    DBGHEX(_stack.end_byte);
+    DBGLN(F(""));
     DBGLN(F(""));
   }
 };
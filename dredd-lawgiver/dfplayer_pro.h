@@ -2,10 +2,14 @@
 #define dfplayerpro_h
 
 #include <Arduino.h>
+#include "easylinkstats.h"
 
 static const char CMD_OK[] PROGMEM =              {"OK\r\n"};
 static const char CMD_ERROR[] PROGMEM =           {"error"};
 
+// time the player takes to switch to music mode
+#define DFPLAYER_PRO_MODE_MS 2000
+
 /**
  * Define the basic structure of class DF Player Pro DF1201S, the implementation of basic methods.
  * This module is a conversion board, which can drive DF1201S DFPlayer PRO MP3 through I2C
@@ -34,35 +38,42 @@ class DFPlayerPro {
   /**
    * Set volume 
    *   vol 0-30
+   *   waitReply read the reply, or leave it when another port has the line
    * Returns Boolean type, the result of seted
    *   true The setting succeeded
    *   false Setting failed
   */
-  bool setVolume(uint8_t vol) {
+  bool setVolume(uint8_t vol, bool waitReply = true) {
     char data[10];
     memset(data, '\0', sizeof(char)*10);
     itoa(vol, data, 10);
 
     drain();
+    TRACE_BEGIN(TRACE_AUDIO_TX);
     writeBuffer(F("AT+VOL="));
     writeBuffer(data);
     writeBuffer(F("\r\n"));
+    LINK_ACTIVITY(LINK_ACT_DELAY);
     delay(30);
+    TRACE_END(TRACE_AUDIO_TX);
 
-    return readAck();
+    if (waitReply)
+      return readAck();
+    return true;
   }
 
   /**
    * Set working mode 
    *   function MUSIC=1,RECORD=2,UFDISK=3
+   *   wait sit out the switch, or leave that to the caller
    * Returns Boolean type, the result of seted
    *   true The setting succeeded
    *   false Setting failed
    */
-  bool musicMode() {
+  bool musicMode(bool wait = true) {
     writeATCommand(F("AT+FUNCTION=1\r\n"));
     if (readAck()) {
-      delay(2000);
+      if (wait) delay(DFPLAYER_PRO_MODE_MS);
       return true;
     }
     return false;
@@ -71,13 +82,16 @@ class DFPlayerPro {
   /**
    * Set playback mode 
    *   mode SINGLECYCLE=1,ALLCYCLE=2,SINGLE=3,RANDOM=4,FOLDER=5
+   *   waitReply read the reply, or leave it when another port has the line
    * Returns Boolean type, the result of seted
    *   true The setting succeeded
    *   false Setting failed
    */
-  bool singlePlayMode() {
+  bool singlePlayMode(bool waitReply = true) {
     writeATCommand(F("AT+PLAYMODE=3\r\n"));
-    return readAck();
+    if (waitReply)
+      return readAck();
+    return true;
   }
 
   /**
@@ -105,10 +119,13 @@ class DFPlayerPro {
     itoa(num, data, 10);
 
     drain();
+    TRACE_BEGIN(TRACE_AUDIO_TX);
     writeBuffer(F("AT+PLAYNUM="));
     writeBuffer(data);
     writeBuffer(F("\r\n"));
+    LINK_ACTIVITY(LINK_ACT_DELAY);
     delay(30);
+    TRACE_END(TRACE_AUDIO_TX);
     if (waitReply)
       return readAck();      
     return true;
@@ -133,8 +150,11 @@ class DFPlayerPro {
     DBGSTR(F("COMMAND: "));
     DBGLN(command);
     drain();
+    TRACE_BEGIN(TRACE_AUDIO_TX);
     _s->print(command);
+    LINK_ACTIVITY(LINK_ACT_DELAY);
     delay(30);
+    TRACE_END(TRACE_AUDIO_TX);
   }
 
   void writeBuffer(const char* buffer) {
@@ -179,9 +199,12 @@ class DFPlayerPro {
         }
         if (buffer[offset - 1] == '\n' && buffer[offset - 2] == '\r') break;
         if (millis() - curr > 1000) {
+          if (offset) LINK_ERROR(LINK_AUDIO, LINK_PARTIAL);
           return getString_P(buffer, CMD_ERROR, 6);
         }
       }
+      // replies are OK or ERROR, anything else lost bytes on the way
+      if (strncmp(buffer, "OK", 2) != 0 && strncmp(buffer, "ER", 2) != 0) LINK_ERROR(LINK_AUDIO, LINK_FRAMING);
       buffer[len] = 0;
     }
     return buffer;
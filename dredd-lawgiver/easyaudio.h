@@ -3,6 +3,8 @@
 
 #define MINI_BAUD_RATE 9600
 #define PRO_BAUD_RATE 115200
+// time the DF Player Mini takes to boot before it plays anything
+#define MINI_BOOT_MS 1000
 // uncomment if you are using the DFPlayer Pro
 //#define ENABLE_EASY_AUDIO_PRO 1
 
@@ -32,6 +34,12 @@
  * 
  * In the main loop, playback the next queued track:
  * eg. audio.playQueuedTrack();
+ *
+ * With ENABLE_FAST_BOOT begin() returns without waiting for the player to
+ * finish booting (or switching to music mode on the Pro). The first track
+ * sits out whatever is left of that and takes the volume along, and the
+ * play mode on the Pro, so set up the rest of the prop in between: the
+ * voice module can have the line while the player gets ready.
  */
 class EasyAudio {
 private:
@@ -44,6 +52,10 @@ class EasyAudio {
 
   unsigned long _lastPlaybackTime = 0;
   long _playbackDelay = 100;
+#if ENABLE_FAST_BOOT == 1
+  unsigned long _readyTime = 0;  // when the player takes commands, 0 once it has
+  uint8_t _volume = 0;
+#endif
 
 public:
   EasyAudio(uint8_t rxPin, uint8_t txPin)
@@ -59,15 +71,28 @@ class EasyAudio {
       return false;
     }
     _player.enableAMP();       // Enable amplifier chip
+#if ENABLE_FAST_BOOT == 1
+    _player.musicMode(false);  // Enter music mode, the first track waits for it
+    _volume = vol;             // sent with the play mode, once the player is in music mode
+    _readyTime = millis() + DFPLAYER_PRO_MODE_MS;
+#else
     _player.musicMode();       // Enter music mode
     _player.singlePlayMode();  // Set playback mode to Play single and pause
     _player.setVolume(vol);    // initial volume, 30 is max, 25 makes the wife not angry
+#endif
 #else
     _mySerial.begin(MINI_BAUD_RATE);
     _player.begin(_mySerial, false);  //set Serial for DFPlayer-mini mp3 module
+#if ENABLE_FAST_BOOT == 1
+    _volume = vol;                    // sent with the first track, once the player is up
+    _readyTime = millis() + MINI_BOOT_MS;
+#else
     _player.volume(vol);                    //initial volume, 30 is max, 3 makes the wife not angry
 #endif
+#endif
+#if ENABLE_FAST_BOOT == 0
     delay(1000);
+#endif
 #endif
     return true;
   }
@@ -78,12 +103,19 @@ class EasyAudio {
    * Our wiring doesn't support it at the moment
    */
   bool isBusy() {
-    if (millis() > (_lastPlaybackTime + _playbackDelay)) {
+    if (millis() > busyUntil()) {
         return false;
     }
     return true;
   }
 
+  /**
+   * The millis() at which the last track's busy window ends, isBusy() is false after it.
+   */
+  unsigned long busyUntil() {
+    return _lastPlaybackTime + _playbackDelay;
+  }
+
   /**
    * play a track by number.
    */
@@ -95,6 +127,8 @@ class EasyAudio {
    * play a track by number, with a specific busy delay
    */
   void playTrack(int track, long busyDelay) {
+    BENCH_BEGIN(BENCH_AUDIO_PLAY);
+    waitReady();
     _playbackDelay = busyDelay;    
     _lastPlaybackTime = millis();
 #if ENABLE_EASY_AUDIO == 1
@@ -103,10 +137,13 @@ class EasyAudio {
   #else
     _player.playFromMP3Folder(track);
   #endif
+    checkLink();
 #endif
+    BENCH_END(BENCH_AUDIO_PLAY);
   }
 
   void playTrackAndWait(int track) {
+    waitReady();
     _lastPlaybackTime = millis();
 #if ENABLE_EASY_AUDIO == 1
   #ifdef ENABLE_EASY_AUDIO_PRO
@@ -118,5 +155,34 @@ class EasyAudio {
 #endif
   }
 
+private:
+  /**
+   * With ENABLE_FAST_BOOT, sits out the rest of the player's boot before the
+   * first track and sends the settings held back by begin().
+   */
+  void waitReady() {
+#if ENABLE_FAST_BOOT == 1 && ENABLE_EASY_AUDIO == 1
+    if (!_readyTime) return;
+    long left = (long)(_readyTime - millis());
+    if (left > 0) delay(left);
+    _readyTime = 0;
+  #ifdef ENABLE_EASY_AUDIO_PRO
+    // the voice module has the line by now, the replies would never come
+    _player.singlePlayMode(false);
+    _player.setVolume(_volume, false);
+  #else
+    _player.volume(_volume);
+  #endif
+#endif
+  }
+
+  /**
+   * Counts a full receive buffer since the last command.
+   */
+  void checkLink() {
+    if (_mySerial.overflow()) LINK_ERROR(LINK_AUDIO, LINK_OVERFLOW);
+    LINK_POLLED(LINK_AUDIO);
+  }
+
 };
 #endif
@@ -0,0 +1,91 @@
+#ifndef easyboottimes_h
+#define easyboottimes_h
+
+/**
+ * Remembers when each stage of the boot finished, from power on to the main
+ * loop, so the fixed waits in setup() and the start up sequence show up.
+ *
+ * Mark the end of a stage with the helper below:
+ * eg. BOOT_STAGE(BOOT_AUDIO);
+ *
+ * Each mark keeps millis() and the time since the mark before it, whichever
+ * stage that was, in a fixed table of about 80 bytes of RAM, so it only
+ * exists with ENABLE_BOOT_TIMES. Send 'b' on the debug port to print it, see
+ * checkDebugCommands() in main.cpp. millis() starts in init(), after the
+ * bootloader has had its turn, so the setup row is only what init() and the
+ * constructors took, and the bootloader isn't in the table at all. A stage
+ * that didn't run has no times.
+ */
+#define BOOT_SETUP              0  // setup() entered
+#define BOOT_AUDIO              1  // player up, retries and waits included
+#define BOOT_LEDS               2
+#define BOOT_VOICE              3
+#define BOOT_OLED               4
+#define BOOT_SETUP_DONE         5
+#define BOOT_LOGO               6  // logo replaced by the comms check
+#define BOOT_COMM_CHK           7
+#define BOOT_DNA_CHK            8  // trigger seen, or gave up
+#define BOOT_DNA_PRG            9
+#define BOOT_ID_OK              10
+#define BOOT_MAIN               11 // main loop starts
+#define BOOT_STAGE_CNT          12
+
+class EasyBootTimes {
+#if ENABLE_BOOT_TIMES == 1
+  private:
+    unsigned long _at[BOOT_STAGE_CNT];
+    uint16_t _took[BOOT_STAGE_CNT];
+    uint16_t _marked = 0;
+    unsigned long _last = 0;
+#endif
+
+  public:
+    void mark(uint8_t stage) {
+#if ENABLE_BOOT_TIMES == 1
+      unsigned long now = millis();
+      _at[stage] = now;
+      _took[stage] = now - _last;
+      _marked |= 1 << stage;
+      _last = now;
+#endif
+    }
+
+    /**
+     * Prints the table on the debug port, times in ms.
+     */
+    void dump() {
+#if ENABLE_BOOT_TIMES == 1
+      static const char NAMES[] PROGMEM = "setup\0audio\0leds\0voice\0oled\0setup done\0"
+                                          "logo\0comm check\0dna check\0dna progress\0id ok\0main\0";
+      Serial.println(F("stage\tat\ttook"));
+      const char *name = NAMES;
+      for (uint8_t i = 0; i < BOOT_STAGE_CNT; i++) {
+        Serial.print((const __FlashStringHelper *)name);
+        if (_marked & (1 << i)) {
+          Serial.print('\t');
+          Serial.print(_at[i]);
+          Serial.print('\t');
+          Serial.print(_took[i]);
+        }
+        Serial.println();
+        name += strlen_P(name) + 1;
+      }
+#endif
+    }
+};
+
+/**
+ * The one table, shared by setup() and the start up sequence.
+ */
+inline EasyBootTimes &bootTimes() {
+  static EasyBootTimes times;
+  return times;
+}
+
+extern inline void BOOT_STAGE(uint8_t stage) {
+#if ENABLE_BOOT_TIMES == 1
+  bootTimes().mark(stage);
+#endif
+}
+
+#endif
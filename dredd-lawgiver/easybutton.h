@@ -26,6 +26,7 @@
 class EasyButton {
 private:
   ezButton _button;
+  uint8_t _pin;
   bool _longPressOnRelease = true;
   unsigned long _pressedTime  = 0;
   unsigned long _releasedTime = 0;
@@ -42,14 +43,14 @@ class EasyButton {
 
 #if ENABLE_EASY_BUTTON == 1
   EasyButton(uint8_t pin, bool signalOnRelease = true)
-    : _button(pin) {
+    : _button(pin), _pin(pin) {
     _longPressOnRelease = signalOnRelease;
     _button.setDebounceTime(50);  // set debounce time to 50 milliseconds
   }
 #else
   // do not initialize the button on the pin
   EasyButton(uint8_t pin, bool signalOnRelease = true)
-    : _button(-1) {
+    : _button(-1), _pin(pin) {
     _longPressOnRelease = signalOnRelease;
     _button.setDebounceTime(50);  // set debounce time to 50 milliseconds
   }
@@ -64,6 +65,7 @@ class EasyButton {
     // track previous state to capture initial press
     bool wasPressed = _isPressing;
     if (_button.isPressed()) {
+      TRACE_INPUT(TRACE_BUTTON_DOWN, _pin);
       //Serial.println(F("button pressed"));
       _pressedTime = millis();
       _isPressing = true;
@@ -71,6 +73,7 @@ class EasyButton {
     }
 
     if (_button.isReleased() && _isPressing == true) {
+      TRACE_INPUT(TRACE_BUTTON_UP, _pin);
       //Serial.println(F("button released"));
       _releasedTime = millis();
       long pressDuration = _releasedTime - _pressedTime;
@@ -118,7 +121,32 @@ class EasyButton {
     return BUTTON_NOT_PRESSED;
   }
 
-  bool pressedLongerThan(int duration) {
+  /**
+   * True while the pin reads different from the debounced state, an edge that hasn't been taken yet.
+   */
+  bool isSettling() {
+#if ENABLE_EASY_BUTTON == 1
+    return _button.getStateRaw() != _button.getState();
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * True from the press until the release, or the long press with signalOnRelease false.
+   */
+  bool isPressing() {
+    return _isPressing;
+  }
+
+  /**
+   * The millis() of the last press.
+   */
+  unsigned long pressedTime() {
+    return _pressedTime;
+  }
+
+  bool pressedLongerThan(unsigned long duration) {
     // if the button is still pressed use millis()
     if (_isPressing) {
       return (millis() - _pressedTime) > duration;
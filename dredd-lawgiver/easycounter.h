@@ -54,7 +54,7 @@ class EasyCounter
       _state = STATE_ACTIVE;
     }
 
-    bool EasyCounter::tick() {
+    bool tick() {
       if (isEmpty()) {
         _state = STATE_EMPTY;
         if (_resetOnEmpty) resetCount();
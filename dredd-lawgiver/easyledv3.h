@@ -3,6 +3,7 @@
 
 #include <FastLED.h>
 #include "ezPattern.h"
+#include "easylinkstats.h"
 
 
 /**
@@ -34,7 +35,7 @@ class EasyLedv3
   protected:
     // variable declaration
     CRGB leds[LED_COUNT];
-    volatile ezPattern *pattern = 0;
+    ezPattern *volatile pattern = 0;
 
   public:
     //some constants for functions
@@ -66,13 +67,19 @@ class EasyLedv3
     void clear() {
 #if ENABLE_EASY_LED == 1
         FastLED.clear();
+        TRACE_BEGIN(TRACE_LED_FRAME);
+        LINK_ACTIVITY(LINK_ACT_LED);
         FastLED.show();
+        TRACE_END(TRACE_LED_FRAME);
 #endif
     }
 
     void show() {
 #if ENABLE_EASY_LED == 1
+      TRACE_BEGIN(TRACE_LED_FRAME);
+      LINK_ACTIVITY(LINK_ACT_LED);
       FastLED.show();
+      TRACE_END(TRACE_LED_FRAME);
 #endif
     }
 
@@ -110,6 +117,7 @@ class EasyLedv3
     void activate(ezPattern &ptn) {
 #if ENABLE_EASY_LED == 1
       //Serial.println(F("activating led pattern"));
+      if (pattern && pattern->isActivated()) BENCH_MARK(BENCH_LED_CUT);
       pattern = &ptn;
       if (pattern)
         pattern->activate(leds, LED_COUNT);
@@ -121,13 +129,16 @@ class EasyLedv3
      * The call is a proxy to the ezPattern, if one has been provided.
      */
     bool updateDisplay() {
+      bool updated = false;
+      BENCH_BEGIN(BENCH_LED_UPDATE);
 #if ENABLE_EASY_LED == 1
       if(LED_COUNT > 0 && LED_PIN_IN > 0) {
         if (pattern)
-          return pattern->updateDisplay(leds, LED_COUNT);
+          updated = pattern->updateDisplay(leds, LED_COUNT);
       }
 #endif
-      return false;
+      BENCH_END(BENCH_LED_UPDATE);
+      return updated;
     }
 };
 
@@ -0,0 +1,155 @@
+#ifndef easylinkstats_h
+#define easylinkstats_h
+
+/**
+ * Counts the bytes lost on the SoftwareSerial links to the voice module and
+ * the audio player, and what the sketch was doing while they were lost.
+ *
+ * A SoftwareSerial port only catches a byte while its interrupt can run and
+ * only keeps 64 of them until they are read. Three things in the main loop
+ * get in the way:
+ *  - FastLED.show() turns interrupts off while it clocks out the strip
+ *  - an OLED page flush keeps the loop away from the port
+ *  - a blocking delay() after an audio command does too
+ * Each one is reported as it happens:
+ * eg. LINK_ACTIVITY(LINK_ACT_LED);
+ *
+ * Each link counts its errors as they are found:
+ * eg. LINK_ERROR(LINK_VOICE, LINK_OVERFLOW);
+ * A full receive buffer is an overflow. SoftwareSerial doesn't check the stop
+ * bit, so a byte caught late only shows up as a broken packet: one with the
+ * wrong head, length or end byte is a framing error, and one that stops part
+ * way is partial. Only one port listens at a time, whatever comes in on the
+ * others is lost without a trace; a poll that finds its port not listening
+ * is deaf. The error goes to the activity that
+ * ran since the link was last polled, the interrupt blackout first:
+ * eg. LINK_POLLED(LINK_VOICE);
+ *
+ * The counters count what the sketch can see, not bytes: one overflow or
+ * deaf spell can swallow several packets. extras/host_sim/lawgiver_links
+ * holds them against the bytes the simulator dropped.
+ *
+ * The counters only exist with ENABLE_LINK_STATS, send 'l' on the debug port
+ * to print them and 'c' to clear them, see checkDebugCommands() in main.cpp.
+ */
+#define LINK_VOICE              0
+#define LINK_AUDIO              1
+#define LINK_CNT                2
+
+#define LINK_OVERFLOW           0
+#define LINK_FRAMING            1
+#define LINK_PARTIAL            2
+#define LINK_DEAF               3
+#define LINK_ERROR_CNT          4
+
+#define LINK_ACT_LED            0x01 // FastLED.show(), interrupts off
+#define LINK_ACT_OLED           0x02 // u8g2 page flush
+#define LINK_ACT_DELAY          0x04 // delay() after an audio command
+#define LINK_CAUSE_CNT          4    // the three above and none of them
+
+class EasyLinkStats {
+#if ENABLE_LINK_STATS == 1
+  private:
+    uint16_t _counts[LINK_CNT][LINK_ERROR_CNT][LINK_CAUSE_CNT];
+    volatile uint8_t _activity[LINK_CNT];
+
+    static uint8_t cause(uint8_t activity) {
+      if (activity & LINK_ACT_LED) return 1;
+      if (activity & LINK_ACT_OLED) return 2;
+      if (activity & LINK_ACT_DELAY) return 3;
+      return 0;
+    }
+#endif
+
+  public:
+    void activity(uint8_t act) {
+#if ENABLE_LINK_STATS == 1
+      for (uint8_t i = 0; i < LINK_CNT; i++) _activity[i] |= act;
+#endif
+    }
+
+    void error(uint8_t link, uint8_t error) {
+#if ENABLE_LINK_STATS == 1
+      uint16_t &count = _counts[link][error][cause(_activity[link])];
+      if (count < 0xFFFF) count++;
+#endif
+    }
+
+    void polled(uint8_t link) {
+#if ENABLE_LINK_STATS == 1
+      _activity[link] = 0;
+#endif
+    }
+
+    /**
+     * One link's count of one error, whatever was running.
+     */
+    unsigned long total(uint8_t link, uint8_t error) {
+      unsigned long sum = 0;
+#if ENABLE_LINK_STATS == 1
+      for (uint8_t k = 0; k < LINK_CAUSE_CNT; k++) sum += _counts[link][error][k];
+#endif
+      return sum;
+    }
+
+    void reset() {
+#if ENABLE_LINK_STATS == 1
+      memset(_counts, 0, sizeof(_counts));
+#endif
+    }
+
+    /**
+     * Prints the counters on the debug port, one row per link and error.
+     */
+    void dump() {
+#if ENABLE_LINK_STATS == 1
+      static const char LINKS[] PROGMEM = "voice\0audio\0";
+      static const char ERRORS[] PROGMEM = "overflow\0framing\0partial\0deaf\0";
+      Serial.println(F("link\terror\ttotal\tnone\tleds\toled\tdelay"));
+      const char *link = LINKS;
+      for (uint8_t i = 0; i < LINK_CNT; i++) {
+        const char *error = ERRORS;
+        for (uint8_t j = 0; j < LINK_ERROR_CNT; j++) {
+          Serial.print((const __FlashStringHelper *)link);
+          Serial.print('\t');
+          Serial.print((const __FlashStringHelper *)error);
+          Serial.print('\t');
+          Serial.print(total(i, j));
+          for (uint8_t k = 0; k < LINK_CAUSE_CNT; k++) {
+            Serial.print('\t');
+            Serial.print(_counts[i][j][k]);
+          }
+          Serial.println();
+          error += strlen_P(error) + 1;
+        }
+        link += strlen_P(link) + 1;
+      }
+#endif
+    }
+};
+
+/**
+ * The one set of counters, shared by every class that touches a link.
+ */
+inline EasyLinkStats &linkStats() {
+  static EasyLinkStats stats;
+  return stats;
+}
+
+extern inline void LINK_ACTIVITY(uint8_t act) {
+#if ENABLE_LINK_STATS == 1
+  linkStats().activity(act);
+#endif
+}
+extern inline void LINK_ERROR(uint8_t link, uint8_t error) {
+#if ENABLE_LINK_STATS == 1
+  linkStats().error(link, error);
+#endif
+}
+extern inline void LINK_POLLED(uint8_t link) {
+#if ENABLE_LINK_STATS == 1
+  linkStats().polled(link);
+#endif
+}
+
+#endif
@@ -8,7 +8,11 @@
 #define U8G2_WITHOUT_UNICODE
 
 #include <U8g2lib.h>
+#include <util/crc16.h>
+#include "easylinkstats.h"
+#include "easyoledlabels.h"
 #endif
+#include "easyoledpolicy.h"
 
 /**
  * A simple class for managing an LED display. It's mainly based on
@@ -17,15 +21,41 @@
  * The main configuration is specified on declaration:
  * eg. EasyOLED<13, 11, 8, 9, 10> oledDisplay;
  *
+ * The transport and the page buffer are policies that follow the pins,
+ * OLED_TRANSPORT and OLED_BUFFER from config.h unless given, see
+ * easyoledpolicy.h
+ * eg. EasyOLED<A5, A4, 12, 11, 10, OledHwI2c, OledPage1> oledDisplay;
+ *
  * In the setup, you can use the begin() function to initialize the display count and brightness.
  * eg. display.begin();
  *
  * The display count can be updated using the updateDisplay() function
  * eg. display.updateDisplay(ammoSelection, ammoCounter);
  *
+ * With ENABLE_OLED_PAGED, updateDisplay() only schedules the frame, and the
+ * main loop sends it one page per pass with updatePage()
+ * eg. display.updatePage();
+ *
+ * On the main screen only the tile rows (8 pixel bands) whose content changed
+ * since the last update are drawn and sent, so a shot only repaints the ammo
+ * counters. The other screens are always drawn whole.
+ *
+ * Every tile row that is sent leaves a CRC behind, and a row that comes out
+ * the same as the one already on the display isn't sent again, so a screen
+ * that only blinks a word only sends the rows of that word.
+ *
+ * With ENABLE_OLED_HW_SPI the display sits on the hardware SPI pins and
+ * the bytes go out through the SPI port at 8 MHz.
+ *
+ * With ENABLE_OLED_LABELS the fixed text, and with ENABLE_OLED_SHAPES the
+ * battery and the grid, are copied into the page from bitmaps made on the
+ * host, and with ENABLE_OLED_COUNTERS the ammo counters are put together
+ * from an atlas of their digits, see easyoledlabels.h.
+ *
  * REQUIRED LIBRARY: U8g2lib
  */
-template<int CL_PIN, int DA_PIN, int CS_PIN, int DC_PIN, int RESET_PIN>
+template<int CL_PIN, int DA_PIN, int CS_PIN, int DC_PIN, int RESET_PIN,
+         class TRANSPORT = OLED_TRANSPORT, class BUFFER = OLED_BUFFER>
 class EasyOLED {
 public:
   static const int DISPLAY_LOGO = 1;
@@ -51,7 +81,9 @@ class EasyOLED {
 #if ENABLE_EASY_OLED == 1
     //Serial.println(F("Initializing OLED display"));
     u8g2.begin();
-    u8g2.setBusClock(8000000);
+    u8g2.setBusClock(TRANSPORT::BUS_CLOCK);
+    // begin() cleared the display, which is what a CRC of 0 stands for
+    memset(_sentCrc, 0, sizeof(_sentCrc));
     _ammoSelection = ammoSelection;
     memcpy(_ammoCounts, ammoCounts, sizeof(_ammoCounts));
 #endif
@@ -110,11 +142,50 @@ class EasyOLED {
       checkAmmoLevels();
     }
     memcpy(_ammoCounts, counters, sizeof(_ammoCounts));
+#if ENABLE_OLED_PAGED == 1
+    _framePending = true;
+#else
     drawDisplay(_displayMode, _progressBar);
+#endif
     //DBGLN(F("OLED - update ammo display"));
   }
 
+  /**
+     * Send the next page of the frame scheduled by updateDisplay(), one per pass of the main loop.
+     * A frame scheduled while the last one is still going out takes over the rows that weren't
+     * sent yet and adds the ones that changed again, so the screen never shows two different
+     * states for longer than a frame.
+     * Returns true when a page was sent.
+     */
+  bool updatePage() {
+#if ENABLE_EASY_OLED == 1 && ENABLE_OLED_PAGED == 1
+    if (_framePending) {
+      _framePending = false;
+      _frameRows |= frameRows(_displayMode);
+      if (!_frameRows) {
+        // nothing on the screen changed
+        BENCH_MARK(BENCH_OLED_DRAW + _displayMode);
+        return false;
+      }
+    }
+    if (!_frameRows) return false;
+    BENCH_BEGIN(BENCH_OLED_PAGE);
+    _frameRows = sendPage(_displayMode, _progressBar, _frameRows);
+    BENCH_END(BENCH_OLED_PAGE);
+    if (!_frameRows) BENCH_MARK(BENCH_OLED_DRAW + _displayMode);
+    return true;
+#else
+    return false;
+#endif
+  }
+
 private:
+  // tile rows of the main screen, bit n is y 8n to 8n+7 from the top
+  static const uint8_t ROWS_ALL = 0xFF;
+  static const uint8_t ROWS_AMMO_NAME = 0x38;    // ammo name and fire mode, grid line and the top of the selection
+  static const uint8_t ROWS_AMMO_COUNTS = 0xC0;  // ammo counters
+  static const uint8_t LINE_NONE = 0xFF;         // the main screen isn't up
+
   // number eof pixels to move the progress bar on startup
   const uint8_t _progressBarIncrement = 10;
   // index of ammo selections and ammo counters based on the config.h
@@ -122,9 +193,7 @@ class EasyOLED {
 
   // See the instructions for optimizing the U8g2 lib.
 #if ENABLE_EASY_OLED == 1
-  U8G2_SH1122_256X64_2_4W_SW_SPI u8g2;
-  //U8G2_SH1122_256X64_2_4W_HW_SPI u8g2;
-  //U8G2_SH1122_256X64_F_4W_HW_SPI u8g2;
+  EasyOledU8g2<TRANSPORT, BUFFER> u8g2;
 #endif
   int _displayMode = 0;  // tracking display modes during start up
   int _progressBar = 0;  // tracking progress during startup sequence
@@ -133,52 +202,229 @@ class EasyOLED {
   uint8_t _ammoCounts[4];      // ammo counts
   bool _blink = false;         // blink controller
   bool _ammoLow = false;       // ammo low state
+  uint8_t _shownCounts[4];             // ammo counts on the main screen
+  uint8_t _shownLine = LINE_NONE;      // ammo name line on the main screen, see ammoLine()
+#if ENABLE_EASY_OLED == 1
+  uint16_t _sentCrc[8];        // CRC of each display tile row as sent
+#endif
+#if ENABLE_OLED_PAGED == 1
+  bool _framePending = false;  // frame scheduled, first page not sent yet
+  uint8_t _frameRows = 0;      // display tile rows of the frame still to send
+#endif
 
   void drawDisplay(int displayMode, int progress) {
+    BENCH_BEGIN(BENCH_OLED_DRAW + displayMode);
+    TRACE_BEGIN(TRACE_OLED_DRAW);
+    uint8_t rows = frameRows(displayMode);
+#if ENABLE_OLED_PAGED == 1
+    // the frame goes out now, along with what was left of the one being paged
+    rows |= _frameRows;
+    _framePending = false;
+    _frameRows = 0;
+#endif
 #if ENABLE_EASY_OLED == 1
-    u8g2.firstPage();
-    do {
-      switch (displayMode) {
-        case DISPLAY_MAIN:
-          drawFiringMode();
-          break;
-        case DISPLAY_LOGO:
-          drawLogo();
-          break;
-        case DISPLAY_COMM_CHK:
-          // COMM OK
-          drawCommOk(progress);
-          break;
-        case DISPLAY_DNA_CHK:
-        case DISPLAY_DNA_PRG:
-          // DNA Check
-          drawDNACheck(progress);
-          break;
-        case DISPLAY_ID_OK:
-          // ID OK
-          drawIDOk(progress);
-          break;
-        case DISPLAY_ID_NAME:
-          // ID NAME
-          drawIDName(progress);
-          break;
-        case DISPLAY_ID_FAIL:
-          // ID FAIL
-          drawIDFail(progress);
-          break;
-        default:
-          // BOOT Error
-          drawBootError();
-          break;
+    while (rows) rows = sendPage(displayMode, progress, rows);
+#endif
+    TRACE_END(TRACE_OLED_DRAW);
+    BENCH_END(BENCH_OLED_DRAW + displayMode);
+  }
+
+  /**
+   * The display tile rows a frame of displayMode has to send. The panel is mounted
+   * upside down (U8G2_R2), so the top row of the screen is the last row of the display.
+   */
+  uint8_t frameRows(int displayMode) {
+    if (displayMode != DISPLAY_MAIN) {
+      _shownLine = LINE_NONE;
+      return ROWS_ALL;
+    }
+    uint8_t rows = changedRows();
+    uint8_t flipped = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+      if (rows & (1 << i)) flipped |= 0x80 >> i;
+    }
+    return flipped;
+  }
+
+  /**
+   * The tile rows of the main screen that differ from what was sent last, which
+   * is then taken as sent.
+   */
+  uint8_t changedRows() {
+    // check if ammo was low but got reset befeore drawing components
+    if (_ammoLow) checkAmmoLevels();
+    uint8_t line = ammoLine();
+    uint8_t rows = 0;
+    if (_shownLine == LINE_NONE) {
+      rows = ROWS_ALL;
+    } else if (line != _shownLine) {
+      // the name line, and the selection box when the ammo changed
+      rows = ROWS_AMMO_NAME | ROWS_AMMO_COUNTS;
+    } else if (memcmp(_shownCounts, _ammoCounts, sizeof(_ammoCounts))) {
+      rows = ROWS_AMMO_COUNTS;
+    }
+    _shownLine = line;
+    memcpy(_shownCounts, _ammoCounts, sizeof(_shownCounts));
+    return rows;
+  }
+
+  /**
+   * What decides the ammo name line of the main screen: the selection, low and empty.
+   */
+  uint8_t ammoLine() {
+    uint8_t line = _ammoSelection;
+    if (_ammoLow) line |= 0x10;
+    if (_ammoCounts[_ammoIdx[_ammoSelection]] == 0) line |= 0x20;
+    return line;
+  }
+
+  /**
+   * Draw the page that starts at the first display tile row in rows and send the
+   * rows of it that are in rows. Returns the rows still to send.
+   */
+  uint8_t sendPage(int displayMode, int progress, uint8_t rows) {
+#if ENABLE_EASY_OLED == 1
+    uint8_t row = 0;
+    while (!(rows & (1 << row))) row++;
+    u8g2.setBufferCurrTileRow(row);
+    u8g2.clearBuffer();
+    drawPage(displayMode, progress);
+
+    TRACE_BEGIN(TRACE_OLED_PAGE);
+    LINK_ACTIVITY(LINK_ACT_OLED);
+    uint8_t width = u8g2.getBufferTileWidth();
+    uint8_t *tiles = u8g2.getBufferPtr();
+    for (uint8_t i = 0; i < u8g2.getBufferTileHeight() && row < 8; i++, row++) {
+      if (rows & (1 << row)) {
+        if (rowChanged(row, tiles, width * 8)) u8x8_DrawTile(u8g2.getU8x8(), 0, row, width, tiles);
+        rows &= ~(1 << row);
       }
-    } while (u8g2.nextPage());
+      tiles += width * 8;
+    }
+    TRACE_END(TRACE_OLED_PAGE);
+#else
+    rows = 0;
+#endif
+    return rows;
+  }
+
+  /**
+   * Draw the part of the screen that falls on the current page.
+   */
+  void drawPage(int displayMode, int progress) {
+#if ENABLE_EASY_OLED == 1
+    switch (displayMode) {
+      case DISPLAY_MAIN:
+        drawFiringMode();
+        break;
+      case DISPLAY_LOGO:
+        drawLogo();
+        break;
+      case DISPLAY_COMM_CHK:
+        // COMM OK
+        drawCommOk(progress);
+        break;
+      case DISPLAY_DNA_CHK:
+      case DISPLAY_DNA_PRG:
+        // DNA Check
+        drawDNACheck(progress);
+        break;
+      case DISPLAY_ID_OK:
+        // ID OK
+        drawIDOk(progress);
+        break;
+      case DISPLAY_ID_NAME:
+        // ID NAME
+        drawIDName(progress);
+        break;
+      case DISPLAY_ID_FAIL:
+        // ID FAIL
+        drawIDFail(progress);
+        break;
+      default:
+        // BOOT Error
+        drawBootError();
+        break;
+    }
 #endif
   }
 
+#if ENABLE_EASY_OLED == 1
+  /**
+   * Compare the CRC of a drawn tile row with the one the display has, returns true
+   * and keeps the new one when they differ.
+   */
+  bool rowChanged(uint8_t row, const uint8_t *tiles, uint16_t len) {
+    uint16_t crc = 0;
+    while (len--) crc = _crc_ccitt_update(crc, *tiles++);
+    if (crc == _sentCrc[row]) return false;
+    _sentCrc[row] = crc;
+    return true;
+  }
+
+#if ENABLE_OLED_LABELS == 1 || ENABLE_OLED_SHAPES == 1
+  /**
+   * Copy the rows of a label in easyoledlabelbits.h that fall on the current
+   * page.
+   */
+  void copyLabel(uint8_t label) {
+    uint8_t x = pgm_read_byte(&oledLabelBox[label][0]);
+    uint8_t width = pgm_read_byte(&oledLabelBox[label][1]);
+    uint8_t line = pgm_read_byte(&oledLabelBox[label][2]);
+    uint8_t lines = pgm_read_byte(&oledLabelBox[label][3]);
+    const uint8_t *bits = oledLabelBits + pgm_read_word(&oledLabelOffset[label]);
+    // lines of the display on the page
+    uint8_t first = u8g2.getBufferCurrTileRow() * 8;
+    uint8_t last = first + u8g2.getBufferTileHeight() * 8;
+    uint8_t stride = u8g2.getBufferTileWidth();
+    for (; lines > 0; lines--, line++, bits += width) {
+      if (line < first || line >= last) continue;
+      uint8_t *buf = u8g2.getBufferPtr() + (line - first) * stride + x;
+      for (uint8_t i = 0; i < width; i++) buf[i] |= pgm_read_byte(bits + i);
+    }
+  }
+#endif
+
+  /**
+   * Draw one of the labels in easyoledlabels.h, copied from
+   * easyoledlabelbits.h when its flag is on.
+   */
+  void drawLabel(uint8_t label) {
+    switch (label) {
+#if ENABLE_OLED_LABELS == 1
+#define OLED_LABEL_DRAW(id, ...) \
+      case OLED_LABEL_##id: \
+        copyLabel(label); \
+        break;
+#else
+#define OLED_LABEL_DRAW(id, font, x, y, text) \
+      case OLED_LABEL_##id: \
+        u8g2.setFont(font); \
+        u8g2.setCursor(x, y); \
+        u8g2.print(text); \
+        break;
+#endif
+      OLED_LABELS(OLED_LABEL_DRAW)
+#undef OLED_LABEL_DRAW
+#if ENABLE_OLED_SHAPES == 1
+#define OLED_SHAPE_DRAW(id, draw) \
+      case OLED_LABEL_##id: \
+        copyLabel(label); \
+        break;
+#else
+#define OLED_SHAPE_DRAW(id, draw) \
+      case OLED_LABEL_##id: \
+        draw(u8g2); \
+        break;
+#endif
+      OLED_SHAPES(OLED_SHAPE_DRAW)
+#undef OLED_SHAPE_DRAW
+    }
+  }
+#endif
+
   void drawFiringMode() {
 #if ENABLE_EASY_OLED == 1
-    // check if ammo was low but got reset befeore drawing components
-    if (_ammoLow) checkAmmoLevels();
     drawGrid();
     drawAmmoMode();
     drawAmmoName();
@@ -188,19 +434,14 @@ class EasyOLED {
 
   void drawLogo() {
 #if ENABLE_EASY_OLED == 1
-    u8g2.setFont(u8g2_font_helvB18_tr);
-    u8g2.setCursor(40, 42);
-    u8g2.print(F("Props3D Pro"));
+    drawLabel(OLED_LABEL_LOGO);
 #endif
   }
 
   void drawBootError() {
 #if ENABLE_EASY_OLED == 1
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(42, 30);
-    u8g2.print(F("BOOT ERROR"));
-    u8g2.setCursor(20, 45);
-    u8g2.print(F("Check battery levels"));
+    drawLabel(OLED_LABEL_BOOT_ERROR);
+    drawLabel(OLED_LABEL_CHECK_BATTERY);
 #endif
   }
 
@@ -215,131 +456,102 @@ class EasyOLED {
 
   void drawCommOk(int progress) {
 #if ENABLE_EASY_OLED == 1
+    drawGrid();
     drawProgress(progress);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(0, 42);
-    u8g2.print(F("COMM OK"));
+    drawLabel(OLED_LABEL_COMM_OK);
     drawAmmoMode();
-    drawGrid();
 #endif
   }
 
   void drawDNACheck(int progress) {
 #if ENABLE_EASY_OLED == 1
+    drawGrid();
     drawProgress(progress);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(0, 42);
-    u8g2.print(F("DNA CHECK"));
+    drawLabel(OLED_LABEL_DNA_CHECK);
     drawAmmoMode();
-    drawGrid();
 #endif
   }
 
   void drawIDOk(int progress) {
 #if ENABLE_EASY_OLED == 1
+    drawGrid();
     drawProgress(progress);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(0, 42);
-    if (_blink) {
-      u8g2.print(F("I.D. OK"));      
-    } else {
-      u8g2.print(F(""));
-    }
+    if (_blink) drawLabel(OLED_LABEL_ID_OK);
     drawAmmoMode();
-    drawGrid();
 #endif
   }
 
   void drawIDFail(int progress) {
 #if ENABLE_EASY_OLED == 1
+    drawGrid();
     drawProgress(progress);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(0, 42);
-    if (_blink) {
-      u8g2.print(F("I.D. FAIL"));
-    } else {
-      u8g2.print(F(""));
-    }
+    if (_blink) drawLabel(OLED_LABEL_ID_FAIL);
     drawAmmoMode();
-    drawGrid();
 #endif
   }
 
   void drawIDName(int progress) {
 #if ENABLE_EASY_OLED == 1
+    drawGrid();
     drawProgress(progress);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(0, 42);
-    u8g2.print((__FlashStringHelper*)DISPLAY_USER_ID);
+    drawLabel(OLED_LABEL_USER_ID);
     drawAmmoMode();
-    drawGrid();
 #endif
   }
 
   void drawGrid() {
 #if ENABLE_EASY_OLED == 1
-    //Battery-State
-    u8g2.drawLine(200, 10, 204, 0);
-    u8g2.drawLine(201, 10, 205, 0);
-    u8g2.drawLine(202, 10, 206, 0);
-    //
-    u8g2.drawLine(205, 10, 209, 0);
-    u8g2.drawLine(206, 10, 210, 0);
-    u8g2.drawLine(207, 10, 211, 0);
-    //
-    u8g2.drawLine(210, 10, 214, 0);
-    u8g2.drawLine(211, 10, 215, 0);
-    u8g2.drawLine(212, 10, 216, 0);
-    //
-    u8g2.drawLine(215, 10, 219, 0);
-    u8g2.drawLine(216, 10, 220, 0);
-    u8g2.drawLine(217, 10, 221, 0);
-    //
-    u8g2.drawLine(220, 10, 224, 0);
-    u8g2.drawLine(221, 10, 225, 0);
-    u8g2.drawLine(222, 10, 226, 0);
-    //
-
-    //Grid
-    u8g2.drawBox(0, 44, 240, 2);
-    u8g2.drawBox(46, 44, 2, 20);
-    u8g2.drawBox(92, 44, 2, 20);
-    u8g2.drawBox(138, 44, 2, 20);
-    u8g2.drawBox(184, 44, 2, 20);
-
-    //distance field
-    u8g2.setFont(u8g2_font_helvB12_tr);
-    u8g2.setCursor(0, 61);
-    //printText(STR_DISTANCE);
-    u8g2.print(F("D:0.0"));    
+    drawLabel(OLED_LABEL_BATTERY);
+    drawLabel(OLED_LABEL_GRID);
 #endif
   }
 
   void drawAmmoField() {
-#if ENABLE_EASY_OLED == 1
+#if ENABLE_EASY_OLED == 1 && ENABLE_OLED_COUNTERS == 1
+    drawCounter(48, 0);
+    drawCounter(95, 1);
+    drawCounter(141, 2);
+    drawCounter(187, 3);
+    // the selected cell, inside the lines of the grid
+    switch (_ammoSelection) {
+      case 0:  // armor piercing
+        invertCell(48, 91);
+        break;
+      case 1:  // incendiary
+      case 2:  // hotshot
+        invertCell(94, 137);
+        break;
+      case 3:  // high explosive
+        invertCell(140, 183);
+        break;
+      default:  // FMJ / STUN / RAPID
+        invertCell(186, 239);
+        break;
+    }
+#elif ENABLE_EASY_OLED == 1
     char _buf[10];               // print buffer for ammo counts
 
     // Standard
-    u8g2.setFont(u8g2_font_helvB12_tr);
+    u8g2.setFont(OLED_COUNTER_FONT);
     u8g2.setDrawColor(1);
-    u8g2.setCursor(48, 61);
+    u8g2.setCursor(48, OLED_COUNTER_Y);
     formatAmmo(_buf, 0);
     u8g2.print(_buf);
-    u8g2.setCursor(95, 61);
+    u8g2.setCursor(95, OLED_COUNTER_Y);
     formatAmmo(_buf, 1);
     u8g2.print(_buf);
-    u8g2.setCursor(141, 61);
+    u8g2.setCursor(141, OLED_COUNTER_Y);
     formatAmmo(_buf, 2);
     u8g2.print(_buf);
     formatAmmo(_buf, 3);
-    u8g2.setCursor(187, 61);
+    u8g2.setCursor(187, OLED_COUNTER_Y);
     u8g2.print(_buf);
     switch (_ammoSelection) {
       case 0:  // armor piercing
         u8g2.setDrawColor(1);
         u8g2.drawBox(46, 46, 46, 20);
         u8g2.setDrawColor(0);
-        u8g2.setCursor(48, 61);
+        u8g2.setCursor(48, OLED_COUNTER_Y);
         formatAmmo(_buf, 0);
         u8g2.print(_buf);
         u8g2.setDrawColor(1);
@@ -349,7 +561,7 @@ class EasyOLED {
         u8g2.setDrawColor(1);
         u8g2.drawBox(92, 46, 46, 20);
         u8g2.setDrawColor(0);
-        u8g2.setCursor(95, 61);
+        u8g2.setCursor(95, OLED_COUNTER_Y);
         formatAmmo(_buf, 1);
         u8g2.print(_buf);
         u8g2.setDrawColor(1);
@@ -358,7 +570,7 @@ class EasyOLED {
         u8g2.setDrawColor(1);
         u8g2.drawBox(138, 46, 46, 20);
         u8g2.setDrawColor(0);
-        u8g2.setCursor(141, 61);
+        u8g2.setCursor(141, OLED_COUNTER_Y);
         formatAmmo(_buf, 2);
         u8g2.print(_buf);
         u8g2.setDrawColor(1);
@@ -367,7 +579,7 @@ class EasyOLED {
         u8g2.setDrawColor(1);
         u8g2.drawBox(184, 46, 56, 20);
         u8g2.setDrawColor(0);
-        u8g2.setCursor(187, 61);
+        u8g2.setCursor(187, OLED_COUNTER_Y);
         formatAmmo(_buf, 3);
         u8g2.print(_buf);
         u8g2.setDrawColor(1);
@@ -376,16 +588,86 @@ class EasyOLED {
 #endif
   }
 
+#if ENABLE_EASY_OLED == 1 && ENABLE_OLED_COUNTERS == 1
+  /**
+   * Draw ammo counter idx from the atlas, the way formatAmmo() and print()
+   * lay it out from x.
+   */
+  void drawCounter(uint8_t x, uint8_t idx) {
+    char digits[4];
+    uint8_t count = _ammoCounts[idx];
+    if (count >= 10) x += OLED_COUNTER_SPACE;
+    itoa(count, digits, 10);
+    for (char *d = digits; *d; d++, x += OLED_COUNTER_ADVANCE) drawCounterGlyph(*d - '0', x);
+    drawCounterGlyph(OLED_COUNTER_SUFFIX + idx, x);
+  }
+
+  /**
+   * OR one entry of the counter atlas into the page, with the cursor at x.
+   * The rows of an entry start at any column, so each byte is split over
+   * two bytes of the buffer.
+   */
+  void drawCounterGlyph(uint8_t glyph, uint8_t x) {
+    int8_t left = pgm_read_byte(&oledCounterBox[glyph][0]);
+    uint8_t width = pgm_read_byte(&oledCounterBox[glyph][1]);
+    uint8_t line = pgm_read_byte(&oledCounterBox[glyph][2]);
+    uint8_t lines = pgm_read_byte(&oledCounterBox[glyph][3]);
+    const uint8_t *bits = oledCounterBits + pgm_read_word(&oledCounterOffset[glyph]);
+    uint8_t bytes = (width + 7) >> 3;
+    // upside down, the glyph's right edge is its first column in the buffer
+    uint8_t column = 255 - (x + left + width - 1);
+    uint8_t shift = column & 7;
+    uint8_t first = u8g2.getBufferCurrTileRow() * 8;
+    uint8_t last = first + u8g2.getBufferTileHeight() * 8;
+    uint8_t stride = u8g2.getBufferTileWidth();
+    for (; lines > 0; lines--, line++, bits += bytes) {
+      if (line < first || line >= last) continue;
+      uint8_t *buf = u8g2.getBufferPtr() + (line - first) * stride + (column >> 3);
+      for (uint8_t i = 0; i < bytes; i++) {
+        uint8_t b = pgm_read_byte(bits + i);
+        buf[i] |= b >> shift;
+        // only pixels of the glyph spill over, so this stays on the line
+        uint8_t spill = b << (8 - shift);
+        if (shift && spill) buf[i + 1] |= spill;
+      }
+    }
+  }
+
+  /**
+   * Invert the counter cell from x0 to x1, from below the grid line to the
+   * bottom of the screen.
+   */
+  void invertCell(uint8_t x0, uint8_t x1) {
+    // upside down: y 46 to 63 are the first 18 lines of the buffer
+    uint8_t from = 255 - x1, to = 255 - x0;
+    uint8_t leftMask = 0xFF >> (from & 7);
+    uint8_t rightMask = 0xFF << (7 - (to & 7));
+    from >>= 3;
+    to >>= 3;
+    uint8_t first = u8g2.getBufferCurrTileRow() * 8;
+    uint8_t last = first + u8g2.getBufferTileHeight() * 8;
+    uint8_t stride = u8g2.getBufferTileWidth();
+    for (uint8_t line = first; line < last && line < 18; line++) {
+      uint8_t *buf = u8g2.getBufferPtr() + (line - first) * stride;
+      if (from == to) {
+        buf[from] ^= leftMask & rightMask;
+        continue;
+      }
+      buf[from] ^= leftMask;
+      for (uint8_t i = from + 1; i < to; i++) buf[i] ^= 0xFF;
+      buf[to] ^= rightMask;
+    }
+  }
+#endif
+
   void drawAmmoMode() {
 #if ENABLE_EASY_OLED == 1
     u8g2.setDrawColor(1);
-    u8g2.setFont(u8g2_font_helvB14_tr);
-    u8g2.setCursor(180, 42);
     if (_displayMode < DISPLAY_MAIN) {
       if (_displayMode == DISPLAY_DNA_CHK)
-        u8g2.print(F("RAPID"));
+        drawLabel(OLED_LABEL_RAPID);
       else
-        u8g2.print(F("SEMI"));
+        drawLabel(OLED_LABEL_SEMI);
     }
 
     if (_displayMode == DISPLAY_MAIN) {
@@ -394,18 +676,17 @@ class EasyOLED {
         // low ammo
       } else if (ammoCount == 0) {
         // empty clip
-        u8g2.print(F("SEMI"));
+        drawLabel(OLED_LABEL_SEMI);
       } else {
         switch (_ammoSelection) {
           case 1:  // incendiary
           case 2:  // hotshot
-            u8g2.print(F(""));
             break;
           case 6:  // FMJ
-            u8g2.print(F("RAPID"));
+            drawLabel(OLED_LABEL_RAPID);
             break;
           default:  // armor p / high ex / stun / FMJ
-            u8g2.print(F("SEMI"));
+            drawLabel(OLED_LABEL_SEMI);
             break;
         }
       }
@@ -417,40 +698,30 @@ class EasyOLED {
 #if ENABLE_EASY_OLED == 1
     int ammoCount = _ammoCounts[_ammoIdx[_ammoSelection]];
     u8g2.setDrawColor(1);
-    u8g2.setFont(u8g2_font_helvB14_tr);
     if (_ammoLow) {
-      u8g2.setCursor(0, 42);
-      u8g2.print(F("AMMUNITION LOW"));
+      drawLabel(OLED_LABEL_AMMO_LOW);
     } else if (ammoCount == 0) {
       // Gun Empty - blink
-      u8g2.setCursor(0, 42);
-      u8g2.print(F("EMPTY"));
+      drawLabel(OLED_LABEL_EMPTY);
     } else {
       switch (_ammoSelection) {
         case 0:
-          u8g2.setCursor(0, 42);
-          u8g2.print(F("ARMOR PIERCING"));
+          drawLabel(OLED_LABEL_ARMOR_PIERCING);
           break;
         case 1:
-          u8g2.setCursor(0, 42);
-          u8g2.print(F("INCENDIARY"));
+          drawLabel(OLED_LABEL_INCENDIARY);
           break;
         case 2:
-          u8g2.setCursor(0, 42);
-          u8g2.print(F("HOT SHOT"));
+          drawLabel(OLED_LABEL_HOT_SHOT);
           break;
         case 3:
-          u8g2.setCursor(0, 42);
-          u8g2.print(F("HIGH EX"));
+          drawLabel(OLED_LABEL_HIGH_EX);
           break;
         case 4:
-          u8g2.setCursor(0, 42);
-          u8g2.print(F("STUN"));
+          drawLabel(OLED_LABEL_STUN);
           break;
         default:
           // FMJ / Rapid
-          u8g2.setCursor(0, 42);
-          u8g2.print(F(""));
           break;
       }
     }
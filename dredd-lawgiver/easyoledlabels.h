@@ -0,0 +1,124 @@
+#ifndef easyoledlabels_h
+#define easyoledlabels_h
+
+/**
+ * The fixed text EasyOLED puts on the screen: what it says, in which font
+ * and where. The battery and the grid of the main screen don't change
+ * either, they are labels drawn by a function. EasyOLED draws a label by
+ * its id
+ * eg. drawLabel(OLED_LABEL_COMM_OK);
+ *
+ * With ENABLE_OLED_LABELS the text labels aren't drawn from the font at
+ * all, and with ENABLE_OLED_SHAPES the battery and grid aren't drawn line
+ * by line.
+ * extras/host_sim/tools/labelgen renders each one at its place on the
+ * screen, upside down like the panel, and writes the buffer bytes of the
+ * lines it covers to easyoledlabelbits.h: 8 pixels of a line to a byte, the
+ * way U8g2 packs the SH1122 page buffer. EasyOLED then ORs those bytes into
+ * the lines of the page, so a label costs about what copying it does,
+ * instead of decoding every glyph on every page.
+ *
+ * easyoledlabelbits.h isn't kept in the repository, it depends on the
+ * U8g2 fonts it's made with. Make it with the real ones before turning the
+ * flags on, and again after changing a label here or DISPLAY_USER_ID in
+ * config.h, see extras/host_sim/README.md. Without it the build stops with
+ * an error saying so.
+ *
+ * The text goes over what is already drawn, so a label mustn't share its
+ * pixels with anything drawn before it.
+ */
+#define OLED_LABELS(L) \
+  L(LOGO,           u8g2_font_helvB18_tr, 40, 42, F("Props3D Pro")) \
+  L(BOOT_ERROR,     u8g2_font_helvB14_tr, 42, 30, F("BOOT ERROR")) \
+  L(CHECK_BATTERY,  u8g2_font_helvB14_tr, 20, 45, F("Check battery levels")) \
+  L(COMM_OK,        u8g2_font_helvB14_tr, 0, 42, F("COMM OK")) \
+  L(DNA_CHECK,      u8g2_font_helvB14_tr, 0, 42, F("DNA CHECK")) \
+  L(ID_OK,          u8g2_font_helvB14_tr, 0, 42, F("I.D. OK")) \
+  L(ID_FAIL,        u8g2_font_helvB14_tr, 0, 42, F("I.D. FAIL")) \
+  L(USER_ID,        u8g2_font_helvB14_tr, 0, 42, (const __FlashStringHelper *)DISPLAY_USER_ID) \
+  L(SEMI,           u8g2_font_helvB14_tr, 180, 42, F("SEMI")) \
+  L(RAPID,          u8g2_font_helvB14_tr, 180, 42, F("RAPID")) \
+  L(AMMO_LOW,       u8g2_font_helvB14_tr, 0, 42, F("AMMUNITION LOW")) \
+  L(EMPTY,          u8g2_font_helvB14_tr, 0, 42, F("EMPTY")) \
+  L(ARMOR_PIERCING, u8g2_font_helvB14_tr, 0, 42, F("ARMOR PIERCING")) \
+  L(INCENDIARY,     u8g2_font_helvB14_tr, 0, 42, F("INCENDIARY")) \
+  L(HOT_SHOT,       u8g2_font_helvB14_tr, 0, 42, F("HOT SHOT")) \
+  L(HIGH_EX,        u8g2_font_helvB14_tr, 0, 42, F("HIGH EX")) \
+  L(STUN,           u8g2_font_helvB14_tr, 0, 42, F("STUN"))
+
+/**
+ * Battery state, top right.
+ */
+extern inline void drawOledBattery(U8G2 &u8g2) {
+  u8g2.drawLine(200, 10, 204, 0);
+  u8g2.drawLine(201, 10, 205, 0);
+  u8g2.drawLine(202, 10, 206, 0);
+  //
+  u8g2.drawLine(205, 10, 209, 0);
+  u8g2.drawLine(206, 10, 210, 0);
+  u8g2.drawLine(207, 10, 211, 0);
+  //
+  u8g2.drawLine(210, 10, 214, 0);
+  u8g2.drawLine(211, 10, 215, 0);
+  u8g2.drawLine(212, 10, 216, 0);
+  //
+  u8g2.drawLine(215, 10, 219, 0);
+  u8g2.drawLine(216, 10, 220, 0);
+  u8g2.drawLine(217, 10, 221, 0);
+  //
+  u8g2.drawLine(220, 10, 224, 0);
+  u8g2.drawLine(221, 10, 225, 0);
+  u8g2.drawLine(222, 10, 226, 0);
+}
+
+/**
+ * The grid of the ammo counters along the bottom, and the distance field
+ * in its first cell.
+ */
+extern inline void drawOledGrid(U8G2 &u8g2) {
+  u8g2.drawBox(0, 44, 240, 2);
+  u8g2.drawBox(46, 44, 2, 20);
+  u8g2.drawBox(92, 44, 2, 20);
+  u8g2.drawBox(138, 44, 2, 20);
+  u8g2.drawBox(184, 44, 2, 20);
+
+  //distance field
+  u8g2.setFont(u8g2_font_helvB12_tr);
+  u8g2.setCursor(0, 61);
+  //printText(STR_DISTANCE);
+  u8g2.print(F("D:0.0"));
+}
+
+#define OLED_SHAPES(S) \
+  S(BATTERY, drawOledBattery) \
+  S(GRID,    drawOledGrid)
+
+#define OLED_LABEL_ID(id, ...) OLED_LABEL_##id,
+enum {
+  OLED_LABELS(OLED_LABEL_ID)
+  OLED_SHAPES(OLED_LABEL_ID)
+  OLED_LABEL_COUNT
+};
+#undef OLED_LABEL_ID
+
+/**
+ * The ammo counters: a count and the suffix of its ammo, in one font on one
+ * baseline, from the left of each cell of the grid. With ENABLE_OLED_COUNTERS
+ * they are put together from an atlas of the digits and the suffixes that
+ * labelgen makes along with the labels, entry OLED_COUNTER_SUFFIX + n being
+ * the suffix of counter n.
+ */
+#define OLED_COUNTER_FONT       u8g2_font_helvB12_tr
+#define OLED_COUNTER_Y          61
+#define OLED_COUNTER_SUFFIXES   {"ap", "in", "he", "fmj"}
+#define OLED_COUNTER_SUFFIX     10
+
+#if ENABLE_OLED_LABELS == 1 || ENABLE_OLED_SHAPES == 1 || ENABLE_OLED_COUNTERS == 1
+#if __has_include("easyoledlabelbits.h")
+#include "easyoledlabelbits.h"
+#else
+#error "ENABLE_OLED_LABELS, ENABLE_OLED_SHAPES and ENABLE_OLED_COUNTERS need easyoledlabelbits.h, make it with labelgen and the real U8g2 fonts, see extras/host_sim/README.md"
+#endif
+#endif
+
+#endif
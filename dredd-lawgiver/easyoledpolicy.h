@@ -0,0 +1,115 @@
+#ifndef easyoledpolicy_h
+#define easyoledpolicy_h
+
+/**
+ * Policies that pick how EasyOLED talks to the SH1122: the transport (the
+ * U8g2 byte and gpio callbacks, the pins and the bus clock) and the page
+ * buffer (how many of the 8 tile rows U8g2 draws at a time). EasyOLED takes
+ * one of each as template parameters, so a build only links the setup, the
+ * buffer and the byte callback it uses.
+ * eg. EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN, OledHwI2c, OledPage1> oled;
+ *
+ * Transports:
+ *  - OledSwSpi     bit-banged 4-wire SPI on any pins
+ *  - OledHwSpi     hardware SPI, waits for every byte
+ *  - OledHwI2c     the TWI port on A4 / A5, at 400 kHz
+ *  - OledSwI2c     bit-banged I2C on the clock and data pins
+ * OledHwSpi needs the ENABLE_OLED_HW_SPI pin map, the I2C ones a panel
+ * jumpered for I2C.
+ *
+ * Buffers, RAM for a 256 pixel wide panel:
+ *  - OledPage1     one tile row, 256 bytes
+ *  - OledPage2     two tile rows, 512 bytes
+ *  - OledFull      the whole screen, 2048 bytes, more than a Nano has
+ *
+ * The defaults are OLED_TRANSPORT and OLED_BUFFER in config.h.
+ */
+struct OledSwSpi;
+struct OledHwSpi;
+struct OledHwI2c;
+struct OledSwI2c;
+struct OledPage1;
+struct OledPage2;
+struct OledFull;
+
+#if ENABLE_EASY_OLED == 1
+struct OledPage1 {
+  static const uint8_t TILE_ROWS = 1;
+  static void setupSpi(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_256x64_1(u8g2, rotation, byte_cb, gpio_cb);
+  }
+  static void setupI2c(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_i2c_256x64_1(u8g2, rotation, byte_cb, gpio_cb);
+  }
+};
+
+struct OledPage2 {
+  static const uint8_t TILE_ROWS = 2;
+  static void setupSpi(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_256x64_2(u8g2, rotation, byte_cb, gpio_cb);
+  }
+  static void setupI2c(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_i2c_256x64_2(u8g2, rotation, byte_cb, gpio_cb);
+  }
+};
+
+struct OledFull {
+  static const uint8_t TILE_ROWS = 8;
+  static void setupSpi(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_256x64_f(u8g2, rotation, byte_cb, gpio_cb);
+  }
+  static void setupI2c(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_cb) {
+    u8g2_Setup_sh1122_i2c_256x64_f(u8g2, rotation, byte_cb, gpio_cb);
+  }
+};
+
+struct OledSwSpi {
+  static const uint32_t BUS_CLOCK = 8000000;
+  template<class BUFFER>
+  static void setup(u8g2_t *u8g2, const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) {
+    BUFFER::setupSpi(u8g2, rotation, u8x8_byte_arduino_4wire_sw_spi, u8x8_gpio_and_delay_arduino);
+    u8x8_SetPin_4Wire_SW_SPI(u8g2_GetU8x8(u8g2), clock, data, cs, dc, reset);
+  }
+};
+
+struct OledHwSpi {
+  static const uint32_t BUS_CLOCK = 8000000;
+  template<class BUFFER>
+  static void setup(u8g2_t *u8g2, const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) {
+    BUFFER::setupSpi(u8g2, rotation, u8x8_byte_arduino_hw_spi, u8x8_gpio_and_delay_arduino);
+    u8x8_SetPin_4Wire_HW_SPI(u8g2_GetU8x8(u8g2), cs, dc, reset);
+  }
+};
+
+struct OledHwI2c {
+  static const uint32_t BUS_CLOCK = 400000;
+  template<class BUFFER>
+  static void setup(u8g2_t *u8g2, const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) {
+    BUFFER::setupI2c(u8g2, rotation, u8x8_byte_arduino_hw_i2c, u8x8_gpio_and_delay_arduino);
+    u8x8_SetPin_HW_I2C(u8g2_GetU8x8(u8g2), reset);
+  }
+};
+
+struct OledSwI2c {
+  static const uint32_t BUS_CLOCK = 400000;
+  template<class BUFFER>
+  static void setup(u8g2_t *u8g2, const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) {
+    BUFFER::setupI2c(u8g2, rotation, u8x8_byte_arduino_sw_i2c, u8x8_gpio_and_delay_arduino);
+    u8x8_SetPin_SW_I2C(u8g2_GetU8x8(u8g2), clock, data, reset);
+  }
+};
+
+/**
+ * The U8g2 display for a transport and a buffer, what the U8G2_SH1122_256X64_*
+ * classes are for one pair of them.
+ */
+template<class TRANSPORT, class BUFFER>
+class EasyOledU8g2 : public U8G2 {
+public:
+  EasyOledU8g2(const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) : U8G2() {
+    TRANSPORT::template setup<BUFFER>(&u8g2, rotation, clock, data, cs, dc, reset);
+  }
+};
+#endif
+
+#endif
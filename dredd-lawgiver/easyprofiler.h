@@ -0,0 +1,186 @@
+#ifndef easyprofiler_h
+#define easyprofiler_h
+
+/**
+ * Times the stages of the main loop on the prop itself.
+ *
+ * Timer1 runs free with a prescaler of 8, so it ticks every 0.5 us on a
+ * 16 MHz Nano, and its overflow interrupt carries the count past 16 bits.
+ * Nothing else in the sketch uses Timer1. Wrap a stage in start() / stop():
+ * eg. profiler.start(PROFILE_OLED_UPDATE);
+ * eg. oled.updateDisplay(selectedAmmoMode, getCounters());
+ * eg. profiler.stop(PROFILE_OLED_UPDATE);
+ *
+ * Every stage keeps its count, min, max and total in a fixed table, plus a
+ * histogram with one bucket per power of two ticks for the p99. The p99 is
+ * the top of the bucket it falls in, so it reads high by up to 2x. The
+ * table takes about 330 bytes of RAM, so it only exists with ENABLE_PROFILE.
+ *
+ * Send 'p' on the debug port to print the table, 'r' to clear it, see
+ * checkDebugCommands() in main.cpp.
+ *
+ * Off the AVR (the host simulator) the ticks come from micros().
+ */
+#define PROFILE_TRIGGER         0
+#define PROFILE_RELOAD          1
+#define PROFILE_LED_UPDATE      2
+#define PROFILE_OLED_UPDATE     3
+#define PROFILE_LOW_AMMO        4
+#define PROFILE_VOICE           5
+#define PROFILE_STAGE_CNT       6
+
+#if ENABLE_PROFILE == 1 && defined(__AVR__)
+volatile uint16_t profilerOverflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+  profilerOverflows++;
+}
+#endif
+
+class EasyProfiler {
+#if ENABLE_PROFILE == 1
+  private:
+    static const uint8_t BUCKET_CNT = 20;   // the last one holds 2^19 ticks (262 ms) and up
+
+    struct Stage {
+      uint16_t count;
+      unsigned long min;
+      unsigned long max;
+      unsigned long total;
+      uint16_t buckets[BUCKET_CNT];
+    };
+    Stage _stages[PROFILE_STAGE_CNT];
+    unsigned long _start = 0;
+
+    // ticks of 0.5 us since begin()
+    unsigned long ticks() {
+#if defined(__AVR__)
+      uint8_t sreg = SREG;
+      cli();
+      uint16_t low = TCNT1;
+      uint16_t high = profilerOverflows;
+      // an overflow that hasn't been serviced yet
+      if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++;
+      SREG = sreg;
+      return ((unsigned long)high << 16) | low;
+#else
+      return micros() * 2;
+#endif
+    }
+
+    static uint8_t bucket(unsigned long ticks) {
+      uint8_t b = 0;
+      while (ticks && b < BUCKET_CNT - 1) {
+        ticks >>= 1;
+        b++;
+      }
+      return b;
+    }
+
+    void add(Stage &s, unsigned long ticks) {
+      if (s.count == 0xFFFF) {
+        // keep the averages and the shape, lose some history
+        s.count >>= 1;
+        s.total >>= 1;
+        for (uint8_t i = 0; i < BUCKET_CNT; i++) s.buckets[i] >>= 1;
+      }
+      if (s.count == 0 || ticks < s.min) s.min = ticks;
+      if (ticks > s.max) s.max = ticks;
+      s.count++;
+      s.total += ticks;
+      s.buckets[bucket(ticks)]++;
+    }
+
+    unsigned long p99(const Stage &s) {
+      // walk down from the top until 1% of the samples are above
+      uint16_t above = s.count / 100;
+      uint16_t seen = 0;
+      for (int8_t i = BUCKET_CNT - 1; i > 0; i--) {
+        seen += s.buckets[i];
+        if (seen > above) return min((1UL << i) - 1, s.max);
+      }
+      return s.max;
+    }
+
+    static void printTicks(unsigned long ticks) {
+      // in us with one decimal
+      Serial.print('\t');
+      Serial.print(ticks / 2);
+      Serial.print(ticks & 1 ? F(".5") : F(".0"));
+    }
+#endif
+
+  public:
+    EasyProfiler() {};
+
+    void begin() {
+#if ENABLE_PROFILE == 1
+      reset();
+#if defined(__AVR__)
+      // normal mode, clk/8
+      TCCR1A = 0;
+      TCCR1B = _BV(CS11);
+      TCNT1 = 0;
+      TIFR1 = _BV(TOV1);
+      TIMSK1 = _BV(TOIE1);
+#endif
+#endif
+    }
+
+    void reset() {
+#if ENABLE_PROFILE == 1
+      memset(_stages, 0, sizeof(_stages));
+#endif
+    }
+
+    void start(uint8_t stage) {
+#if ENABLE_PROFILE == 1
+      _start = ticks();
+#endif
+    }
+
+    void stop(uint8_t stage) {
+#if ENABLE_PROFILE == 1
+      add(_stages[stage], ticks() - _start);
+#endif
+    }
+
+    /**
+     * Time spent in a stage since the last reset, in ticks of 0.5 us. Drops
+     * by half when the stage's count wraps.
+     */
+    unsigned long total(uint8_t stage) {
+#if ENABLE_PROFILE == 1
+      return _stages[stage].total;
+#else
+      return 0;
+#endif
+    }
+
+    /**
+     * Prints the table on the debug port, times in us.
+     */
+    void dump() {
+#if ENABLE_PROFILE == 1
+      static const char NAMES[] PROGMEM = "trigger\0reload\0leds\0oled\0low ammo\0voice\0";
+      Serial.println(F("stage\tcount\tmin\tavg\tmax\tp99"));
+      const char *name = NAMES;
+      for (uint8_t i = 0; i < PROFILE_STAGE_CNT; i++) {
+        const Stage &s = _stages[i];
+        Serial.print((const __FlashStringHelper *)name);
+        Serial.print('\t');
+        Serial.print(s.count);
+        if (s.count) {
+          printTicks(s.min);
+          printTicks(s.total / s.count);
+          printTicks(s.max);
+          printTicks(p99(s));
+        }
+        Serial.println();
+        name += strlen_P(name) + 1;
+      }
+#endif
+    }
+};
+
+#endif
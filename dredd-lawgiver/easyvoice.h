@@ -4,6 +4,7 @@
 #if ENABLE_EASY_VOICE == 1
 #include "easyvr.h"
 #endif 
+#include "easylinkstats.h"
 
 /**
  * This is the factory baud rate the module is shipped with.
@@ -44,7 +45,7 @@ class EasyVoice
     EasyVR _myVR;   // 6:RX 7:TX, you can choose your favourite pins.
 #endif
 
-    uint8_t *_records = RECORDS;
+    const uint8_t *_records = RECORDS;
     uint8_t _recordCnt = RECORD_CNT;
     uint8_t _buf[64];
 
@@ -71,11 +72,21 @@ class EasyVoice
      *  Check the senors buffer for recognized commands.
      *  Returns the index of the recognized command.
      *  Otherwise returns -1
+     *
+     *  Returns at once when nothing has come in, recognize() would hold the
+     *  loop for its whole timeout and the trigger wouldn't be read meanwhile.
      */
     int readCommand()
     {
 #if ENABLE_EASY_VOICE == 1
-      int ret = _myVR.recognize(_buf, 50);
+      int ret = -1;
+      if (_myVR.available()) {
+        TRACE_BEGIN(TRACE_VOICE_POLL);
+        ret = _myVR.recognize(_buf, 50);
+        TRACE_END(TRACE_VOICE_POLL);
+        checkPacket();
+      }
+      checkLink();
       if (ret > 0) {
         return _buf[1];
       }
@@ -83,6 +94,40 @@ class EasyVoice
       return -1;
     }
 
+  private:
+    /**
+     * Counts a packet recognize() couldn't make sense of.
+     */
+    void checkPacket() {
+#if ENABLE_EASY_VOICE == 1
+      int status = _myVR.status();
+      if (status == -5) {
+        LINK_ERROR(LINK_VOICE, LINK_PARTIAL);
+      } else if (status < -1) {
+        LINK_ERROR(LINK_VOICE, LINK_FRAMING);
+      }
+#endif
+    }
+
+    /**
+     * Counts what went wrong on the link since the last poll.
+     */
+    void checkLink() {
+#if ENABLE_EASY_VOICE == 1
+      if (_myVR.overflow()) LINK_ERROR(LINK_VOICE, LINK_OVERFLOW);
+#if ENABLE_LINK_STATS == 1
+      // another port took the line, the words said meanwhile are gone;
+      // listen() clears the overflow flag, so that goes first. Taking the
+      // line back is only done for the counters, so the next poll counts
+      // from here, the sketch without them leaves the listener alone
+      if (!_myVR.isListening()) {
+        LINK_ERROR(LINK_VOICE, LINK_DEAF);
+        _myVR.listen();
+      }
+#endif
+      LINK_POLLED(LINK_VOICE);
+#endif
+    }
 };
 
 #endif
@@ -42,6 +42,7 @@ class EasyVR : public SoftwareSerial {
   int recognize(uint8_t *buf, int timeout) {
     int ret, i;
     ret = receive_pkt(vr_buf, timeout);
+    _status = ret;
     if (vr_buf[2] != FRAME_CMD_VR) {
       return -1;
     }
@@ -55,10 +56,18 @@ class EasyVR : public SoftwareSerial {
     return 0;
   }
 
+  /**
+   * Result of the last packet, see receive_pkt().
+   */
+  int status() {
+    return _status;
+  }
+
 
 private:
   /** temp data buffer */
   uint8_t vr_buf[32];
+  int _status = -1;
 
 
   /**
@@ -67,7 +76,9 @@ class EasyVR : public SoftwareSerial {
    *   timeout --> time of reveiving
    *  Returns integer
    *    '>0' --> success, packet lenght(length of all data in buf)
-   *    '<0' --> failed
+   *    '-1' --> no packet
+   *    '-2' .. '-4' --> bad head, length or end byte
+   *    '-5' --> packet stopped part way
    */
   int receive_pkt(uint8_t *buf) {
     return receive_pkt(buf, VR_DEFAULT_TIMEOUT);
@@ -77,15 +88,19 @@ class EasyVR : public SoftwareSerial {
     int ret;
     ret = receive(buf, 2, timeout);
     if (ret != 2) {
-      return -1;
+      return ret ? -5 : -1;
     }
     if (buf[0] != FRAME_HEAD) {
       return -2;
     }
-    if (buf[1] < 2) {
+    // the length has to fit in vr_buf
+    if (buf[1] < 2 || buf[1] > sizeof(vr_buf) - 2) {
       return -3;
     }
     ret = receive(buf + 2, buf[1], timeout);
+    if (ret != buf[1]) {
+      return -5;
+    }
     if (buf[buf[1] + 1] != FRAME_END) {
       return -4;
     }
@@ -2,6 +2,7 @@
 #define ezpattern_h
 
 #include <FastLED.h>
+#include "easylinkstats.h"
 
 typedef void (*callback_function)(void); // type for conciseness
 
@@ -35,7 +36,11 @@ class ezPattern {
     // fucntion declartions
     void show() {
 #if ENABLE_EASY_LED == 1
+      TRACE_BEGIN(TRACE_LED_FRAME);
+      LINK_ACTIVITY(LINK_ACT_LED);
       FastLED.show();
+      BENCH_MARK(BENCH_LED_SHOW);
+      TRACE_END(TRACE_LED_FRAME);
 #endif
     }
     void clear(CRGB *leds, uint8_t count) {
@@ -152,7 +157,7 @@ class ezBlasterShot : public ezPattern
         return true;
       }
       if (_activated == 3) {
-        long duration = millis() - _flashTimer;
+        unsigned long duration = millis() - _flashTimer;
         if (duration > _flashDuration) {
           _activated = 2;   // start the fade
           _blendRate = calcBlendRate(_startColor, _targetColor);    // reset blend rate
@@ -278,7 +283,7 @@ class ezBlasterRepeatingShot : public ezBlasterShot
         return true;
       }
       if (_activated == 3) {
-        long duration = millis() - _flashTimer;
+        unsigned long duration = millis() - _flashTimer;
         if (duration > _flashDuration) {
           if (_repetitions > 0) {
             _activated = 4;   // clear and flash again
@@ -297,7 +302,7 @@ class ezBlasterRepeatingShot : public ezBlasterShot
 
   public:
     ezBlasterRepeatingShot(uint8_t reps = 8, uint8_t speed = 6, callback_function callback = 0) : ezBlasterRepeatingShot(CRGB::White, reps, speed, callback) {}
-    ezBlasterRepeatingShot(CRGB initialColor, uint8_t reps = 8, uint8_t speed = 6, callback_function callback = 0) : _maxRepetitions(reps), ezBlasterShot(initialColor, CRGB::Black, speed, callback) {
+    ezBlasterRepeatingShot(CRGB initialColor, uint8_t reps = 8, uint8_t speed = 6, callback_function callback = 0) : ezBlasterShot(initialColor, CRGB::Black, speed, callback), _maxRepetitions(reps) {
       _repetitions = _maxRepetitions;
       _flashDuration = 59;
       _frameRate = 60;
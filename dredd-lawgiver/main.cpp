@@ -12,6 +12,8 @@
 #include "easyledv3.h"
 #include "easyoled.h"
 #include "easyvoice.h"
+#include "easyprofiler.h"
+#include "easyboottimes.h"
 
 /**
  * All components are controlled or enabled by "config.h". Before running,
@@ -39,6 +41,9 @@ EasyCounter fmjCounter;
 EasyButton trigger(TRIGGER_PIN, true);
 EasyButton reload(RELOAD_PIN, true);
 
+// Stage timings for the main loop, empty unless ENABLE_PROFILE is set
+EasyProfiler profiler;
+
 /**
  * function declarations
  */
@@ -54,6 +59,7 @@ bool lowAmmoReached(void);
 bool checkTriggerSwitch(void);
 bool checkReloadSwitch(void);
 void checkVoiceCommands(void);
+void checkDebugCommands(void);
 void setNextAmmoMode(void);
 void changeAmmoMode(int mode);
 
@@ -106,6 +112,7 @@ volatile uint8_t activateReload      = 0;                     // sets main loop
 volatile bool    activateThemeTrack  = 0;                     // play theme track
 
 void setup() {
+  BOOT_STAGE(BOOT_SETUP);
 #if ENABLE_DEBUG == 1
   Serial.begin(115200);
 #endif
@@ -123,27 +130,43 @@ void setup() {
   // select the initial ammo mode
   selectedAmmoMode = VR_CMD_AMMO_MODE_FMJ;
 
+#if ENABLE_FAST_BOOT == 1
+  // put the logo up first, the rest boots while it's showing
+  oled.begin(selectedAmmoMode, getCounters());
+  startUpSequence();
+  BOOT_STAGE(BOOT_OLED);
+#endif
+
   //initializes the audio player and sets the volume
   int bootAttempts = 0;
   while (bootAttempts < 3 && !audio.begin(30)) {
     bootAttempts++;
-    delay(3000);
+    delay(TIMING_AUDIO_RETRY_MS);
   }
   if (bootAttempts == 3) loopStage = LOOP_STATE_ERROR;
+  BOOT_STAGE(BOOT_AUDIO);
 
   // initialize the trigger led and set brightness
   fireLed.begin(75);
+  BOOT_STAGE(BOOT_LEDS);
 
   // init the voice recognition module
   voice.begin();
+  BOOT_STAGE(BOOT_VOICE);
 
+#if ENABLE_FAST_BOOT == 0
   // init the display
   oled.begin(selectedAmmoMode, getCounters());
+  BOOT_STAGE(BOOT_OLED);
+#endif
 
   // set up all the triggers as pullup inputs
   // set up the fire trigger and the debounce threshold
   trigger.begin(25);
   reload.begin(25);
+
+  profiler.begin();
+  BOOT_STAGE(BOOT_SETUP_DONE);
 }
 
 /**
@@ -195,13 +218,41 @@ void loop() {
  *    a. playback change mode track
  *    b. toggle fire mode based on the recognized command
  *  7. Refresh or Update the OLED Display
+ *  8. Answer commands on the debug port
  */
 void mainLoop(void) {
+  BENCH_BEGIN(BENCH_MAIN_LOOP);
+  TRACE_BEGIN(TRACE_MAIN_LOOP);
   // always check the triggers first
-  bool audioPlayed = !checkTriggerSwitch() ? checkReloadSwitch() : true;
+  profiler.start(PROFILE_TRIGGER);
+  bool audioPlayed = checkTriggerSwitch();
+  profiler.stop(PROFILE_TRIGGER);
+  if (!audioPlayed) {
+    profiler.start(PROFILE_RELOAD);
+    audioPlayed = checkReloadSwitch();
+    profiler.stop(PROFILE_RELOAD);
+  }
   // Update the triggers LEDS in case they were activated. This should always be run in the main loop.
   //if (audioPlayed)   DBGLN(F("main - led update"));
+  profiler.start(PROFILE_LED_UPDATE);
   bool ledsUpdated = fireLed.updateDisplay();
+  profiler.stop(PROFILE_LED_UPDATE);
+
+  bool pageSent = false;
+#if ENABLE_OLED_PAGED == 1
+  // scheduling only records the state, so it doesn't wait for the LEDs and audio,
+  // and one frame of the latest state covers every redraw that was queued
+  if (screenUpdates) {
+    oled.updateDisplay(selectedAmmoMode, getCounters());
+    screenUpdates = 0;
+  }
+  // hold the page back while the trigger settles, so the debounce sees the edge on the next pass
+  if (!audioPlayed && !trigger.isSettling()) {
+    profiler.start(PROFILE_OLED_UPDATE);
+    pageSent = oled.updatePage();
+    profiler.stop(PROFILE_OLED_UPDATE);
+  }
+#endif
 
   // check low ammo or voice commands if no audio was played
   if (!activateThemeTrack && !audio.isBusy() && !ledsUpdated) {
@@ -209,18 +260,27 @@ void mainLoop(void) {
     if (activateLowAmmo) {
       // small delay so not to collide with ammo playback
       if (millis() > (lowAmmoChangeTime + TIMING_LOW_AMMO_WAIT_MS)) {
+        profiler.start(PROFILE_LOW_AMMO);
         activateLowAmmoIndicators();
+        profiler.stop(PROFILE_LOW_AMMO);
       }
     } else if (screenUpdates) {
       DBGLN(F("main - screen update"));
+      profiler.start(PROFILE_OLED_UPDATE);
       oled.updateDisplay(selectedAmmoMode, getCounters());
+      profiler.stop(PROFILE_OLED_UPDATE);
       screenUpdates--;
-    } else {
-      // check for new voice commands, only if no audio sounds were triggered
+    } else if (!pageSent) {
+      // check for new voice commands, only if no audio sounds were triggered and no frame is going out
       //DBGLN(F("main - check VR"));
+      profiler.start(PROFILE_VOICE);
       checkVoiceCommands();
+      profiler.stop(PROFILE_VOICE);
     }
   }
+  checkDebugCommands();
+  TRACE_END(TRACE_MAIN_LOOP);
+  BENCH_END(BENCH_MAIN_LOOP);
 }
 
 /**
@@ -234,13 +294,14 @@ bool checkTriggerSwitch(void) {
   int buttonStateFire = trigger.checkState();
   // check if a trigger is pressed.
   if (buttonStateFire == EasyButton::BUTTON_PRESSED) {
+    BENCH_MARK(BENCH_TRIGGER_PRESSED);
     handleAmmoDown();
     activateThemeTrack = 0;
     return true;
   }
 
   if (buttonStateFire == EasyButton::BUTTON_HOLD_PRESS) {
-    if (!activateThemeTrack && trigger.pressedLongerThan(6000)) {
+    if (!activateThemeTrack && trigger.pressedLongerThan(TIMING_THEME_HOLD_MS)) {
       audio.playTrack(AUDIO_TRACK_THEME);
       activateThemeTrack = 1;
       return true;
@@ -248,7 +309,7 @@ bool checkTriggerSwitch(void) {
   }
 
   if (buttonStateFire == EasyButton::BUTTON_LONG_PRESS) {
-    if (!trigger.pressedLongerThan(6000)) {
+    if (!trigger.pressedLongerThan(TIMING_THEME_HOLD_MS)) {
       activateThemeTrack = 0;
       setNextAmmoMode();
       return true;
@@ -284,6 +345,7 @@ bool checkReloadSwitch(void) {
  *  8. Display Ammo mode
  */
 void startUpSequence(void) {
+  BENCH_BEGIN(BENCH_STARTUP);
   int _sequenceMode = oled.getDisplayMode();
 
   if (_sequenceMode == 0) {
@@ -294,6 +356,11 @@ void startUpSequence(void) {
   if (_sequenceMode == oled.DISPLAY_LOGO) {
     if (millis() > (TIMING_STARTUP_LOGO_MS + lastDisplayUpdate)) {
       DBGLN(F("Startup - Comm Ok"));
+      BOOT_STAGE(BOOT_LOGO);
+#if ENABLE_FAST_BOOT == 1 && !defined(ENABLE_EASY_AUDIO_PRO)
+      // wake the df mini now, so the DNA check doesn't wait for it
+      audio.playTrack(AUDIO_TRACK_SILENCE);
+#endif
       oled.updateDisplayMode(oled.DISPLAY_COMM_CHK, 0);
       // Red led on
       toggleLED(RED_LED_PIN);
@@ -307,6 +374,7 @@ void startUpSequence(void) {
     }
     if (progressBarUpdates > 9) {
       DBGLN(F("Startup - DNA Chk"));
+      BOOT_STAGE(BOOT_COMM_CHK);
       oled.updateDisplayMode(oled.DISPLAY_DNA_CHK, progressBarUpdates);
       lastDisplayUpdate = millis();
     }
@@ -315,10 +383,11 @@ void startUpSequence(void) {
     // A trigger press is required to complete the DNA check
     bool buttonPressed = (digitalRead(TRIGGER_PIN) == LOW);
     if (buttonPressed || millis() > (TIMING_STARTUP_DNA_CHK_MS + lastDisplayUpdate)) {
+      BOOT_STAGE(BOOT_DNA_CHK);
       if (buttonPressed) {
         DBGLN(F("Startup - DNA Progress - start audio"));
         oled.updateDisplayMode(oled.DISPLAY_DNA_PRG, progressBarUpdates);
-#ifndef ENABLE_EASY_AUDIO_PRO
+#if !defined(ENABLE_EASY_AUDIO_PRO) && ENABLE_FAST_BOOT == 0
         // This is a hack around specifically for df mini players
         audio.playTrack(AUDIO_TRACK_SILENCE);
         delay(1000);
@@ -327,7 +396,7 @@ void startUpSequence(void) {
       } else {
         DBGLN(F("Startup - ID FAIL"));
         oled.updateDisplayMode(oled.DISPLAY_ID_FAIL, progressBarUpdates);
-#ifndef ENABLE_EASY_AUDIO_PRO
+#if !defined(ENABLE_EASY_AUDIO_PRO) && ENABLE_FAST_BOOT == 0
         // This is a hack around specifically for df mini players
         audio.playTrack(AUDIO_TRACK_SILENCE);
         delay(1000);
@@ -354,6 +423,7 @@ void startUpSequence(void) {
     }
     if (progressBarUpdates > 18) {
       DBGLN(F("Startup - ID OK"));
+      BOOT_STAGE(BOOT_DNA_PRG);
       oled.updateDisplayMode(oled.DISPLAY_ID_OK, progressBarUpdates);
       // RED LED off
       toggleLED(RED_LED_PIN);
@@ -375,6 +445,7 @@ void startUpSequence(void) {
     // blink the green led three times before moving on
     if (ledBlinks > 2 && millis() > (TIMING_STARTUP_ID_OK_MS + lastDisplayUpdate)) {
       DBGLN(F("Startup - ID Name"));
+      BOOT_STAGE(BOOT_ID_OK);
       oled.updateDisplayMode(oled.DISPLAY_ID_NAME, progressBarUpdates);
       lastDisplayUpdate = millis();
     }
@@ -383,6 +454,7 @@ void startUpSequence(void) {
   if (_sequenceMode == oled.DISPLAY_ID_NAME) {
     if (millis() > (TIMING_STARTUP_ID_NAME_MS + lastDisplayUpdate)) {
       DBGLN(F("Startup - Main loop"));
+      BOOT_STAGE(BOOT_MAIN);
       audio.playTrack(AUDIO_TRACK_AMMO_LOAD);
       oled.updateDisplayMode(oled.DISPLAY_MAIN, progressBarUpdates);
       // let's turn off the ammo indicators
@@ -414,6 +486,7 @@ void startUpSequence(void) {
   }
   if (_sequenceMode != oled.getDisplayMode())
     DBGLN(F("Startup - changing modes"));
+  BENCH_END(BENCH_STARTUP);
 }
 
 /**
@@ -446,8 +519,8 @@ void reloadAmmo(void) {
  *    2. Checks for an empty clip
  *       a. play empty clip track
  *    3. If clip is not empty
- *       a. queue audio track
- *       b. activate led strip
+ *       a. activate led strip
+ *       b. queue audio track
  *       c. activate oled refresh
  *       d. Check for low ammo
  */
@@ -461,14 +534,14 @@ void handleAmmoDown(void) {
     return;
   }
   //DBGLN(F("Ammo fire sequence"));
-  //play the track
-  playSelectedTrack(AMMO_MODE_IDX_FIRE);
-  // activate the led pulse
+  // activate the led pulse first, sending the track holds the loop for ~40 ms
   //DBGLN(F("handleAmmo - activate leds"));
   if (selectedAmmoMode == VR_CMD_AMMO_MODE_RAPID)
     fireLed.activate(repeatingShot);  // rapid shot - mulitple flashes with fade
   else
     fireLed.activate(blasterShot);
+  //play the track
+  playSelectedTrack(AMMO_MODE_IDX_FIRE);
 
   // check for low ammo, and set the timer
   if (lowAmmoReached()) {
@@ -524,6 +597,26 @@ void setNextAmmoMode(void) {
   changeAmmoMode(mode);
 }
 
+/**
+ * Answers the single letter commands typed into the serial monitor.
+ * - p prints the loop profile, r clears it
+ * - l prints the serial link counters, c clears them
+ * - b prints the boot stage times
+ */
+void checkDebugCommands(void) {
+#if ENABLE_DEBUG == 1
+  while (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case 'p': profiler.dump(); break;
+      case 'r': profiler.reset(); break;
+      case 'l': linkStats().dump(); break;
+      case 'c': linkStats().reset(); break;
+      case 'b': bootTimes().dump(); break;
+    }
+  }
+#endif
+}
+
 /**
  *  Checks the voice recognition module for new voice commands
  *  1. change the selected ammo mode
@@ -535,6 +628,7 @@ void checkVoiceCommands(void) {
   int cmd = voice.readCommand();
 
   if (cmd > -1) {
+    TRACE_INPUT(TRACE_VOICE_COMMAND, cmd);
     changeAmmoMode(cmd);
   }
 }
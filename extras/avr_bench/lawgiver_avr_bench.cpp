@@ -0,0 +1,340 @@
+/**
+ * Cycle counting benchmark for the Lawgiver firmware.
+ *
+ * Runs the real ATmega328P build of the sketch under simavr and counts CPU
+ * cycles for the sections marked with BENCH_BEGIN/BENCH_END in the firmware
+ * (see config.h). The sketch has to be built with ENABLE_BENCH=1, which makes
+ * each probe write its id to GPIOR0; the benchmark watches that register and
+ * reads the simulator's cycle counter on every write.
+ *
+ * The trigger is held through the start up sequence to pass the DNA check,
+ * then released as soon as the main loop runs. After that the trigger is
+ * pulled --shots times, one every --shot-interval ms, with the reload button
+ * pressed after every --reload-every shots. The serial RX pins idle high and
+ * nothing answers on them, the same as a Mini that never replies.
+ *
+ * With --budget the maximum cycles of every section are checked against a
+ * file of "name cycles" lines, and the run fails when one is over.
+ * --write-budget writes such a file from this run, with 10% headroom.
+ *
+ * Usage: lawgiver_avr_bench [--shots N] [--shot-interval MS] [--press MS]
+ *                           [--reload-every N] [--budget FILE]
+ *                           [--write-budget FILE] firmware.elf
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/avr_ioport.h>
+
+namespace {
+
+// keep in step with config.h
+const int VOICE_RX_PIN = 2;
+const int AUDIO_RX_PIN = 4;
+const int TRIGGER_PIN = 8;
+const int RELOAD_PIN = 9;
+
+const uint8_t BENCH_MAIN_LOOP = 1;
+const uint8_t BENCH_STARTUP = 2;
+const uint8_t BENCH_LED_UPDATE = 3;
+const uint8_t BENCH_AUDIO_PLAY = 4;
+const uint8_t BENCH_TRIGGER_PRESSED = 5;
+const uint8_t BENCH_AUDIO_TX = 6;
+const uint8_t BENCH_LED_SHOW = 7;
+const uint8_t BENCH_LED_CUT = 8;
+const uint8_t BENCH_OLED_PAGE = 9;
+const uint8_t BENCH_OLED_DRAW = 16;
+const uint8_t BENCH_END_FLAG = 0x80;
+
+const avr_io_addr_t GPIOR0_ADDR = 0x3E;  // data space address of GPIOR0
+const unsigned long F_CPU = 16000000UL;
+const avr_cycle_count_t MS = F_CPU / 1000;
+const avr_cycle_count_t STARTUP_LIMIT = 60000 * MS;
+
+const char *DISPLAY_NAMES[] = {"", "LOGO", "COMM_CHK", "DNA_CHK", "DNA_PRG", "ID_OK", "ID_NAME", "MAIN", "ID_FAIL", "BOOT_ERROR"};
+
+std::string probeName(uint8_t id) {
+  switch (id) {
+    case BENCH_MAIN_LOOP:
+      return "mainLoop";
+    case BENCH_STARTUP:
+      return "startUpSequence";
+    case BENCH_LED_UPDATE:
+      return "EasyLedv3::updateDisplay";
+    case BENCH_AUDIO_PLAY:
+      return "EasyAudio::playTrack";
+    case BENCH_TRIGGER_PRESSED:
+      return "mark/trigger pressed";
+    case BENCH_AUDIO_TX:
+      return "mark/audio byte out";
+    case BENCH_LED_SHOW:
+      return "mark/led frame";
+    case BENCH_LED_CUT:
+      return "mark/led pattern cut";
+    case BENCH_OLED_PAGE:
+      return "EasyOLED::updatePage";
+  }
+  if (id >= BENCH_OLED_DRAW && id - BENCH_OLED_DRAW < (int)(sizeof(DISPLAY_NAMES) / sizeof(DISPLAY_NAMES[0]))) {
+    return std::string("EasyOLED::drawDisplay/") + DISPLAY_NAMES[id - BENCH_OLED_DRAW];
+  }
+  char name[16];
+  snprintf(name, sizeof(name), "probe_%u", id);
+  return name;
+}
+
+/** Cycles spent in one probed section, nested calls included. */
+struct Section {
+  unsigned long calls = 0;
+  avr_cycle_count_t total = 0;
+  avr_cycle_count_t min = ~(avr_cycle_count_t)0;
+  avr_cycle_count_t max = 0;
+};
+
+/** Pairs up probe writes and keeps the cycle counts per section. */
+class Probes {
+public:
+  std::map<uint8_t, Section> sections;
+  unsigned long unmatched = 0;
+  bool mainLoopSeen = false;
+
+  void write(uint8_t value, avr_cycle_count_t cycle) {
+    uint8_t id = value & ~BENCH_END_FLAG;
+    if (!(value & BENCH_END_FLAG)) {
+      _open.push_back(Open{id, cycle});
+      if (id == BENCH_MAIN_LOOP) mainLoopSeen = true;
+      return;
+    }
+    // close the section, dropping anything left open inside it
+    while (!_open.empty() && _open.back().id != id) {
+      _open.pop_back();
+      unmatched++;
+    }
+    if (_open.empty()) {
+      unmatched++;
+      return;
+    }
+    avr_cycle_count_t cycles = cycle - _open.back().start;
+    _open.pop_back();
+    Section &s = sections[id];
+    s.calls++;
+    s.total += cycles;
+    if (cycles < s.min) s.min = cycles;
+    if (cycles > s.max) s.max = cycles;
+  }
+
+private:
+  struct Open {
+    uint8_t id;
+    avr_cycle_count_t start;
+  };
+  std::vector<Open> _open;
+};
+
+/** A pin change at a given cycle. */
+struct Edge {
+  avr_cycle_count_t at;
+  int pin;
+  int level;
+};
+
+void probeWritten(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+  avr->data[addr] = v;
+  static_cast<Probes *>(param)->write(v, avr->cycle);
+}
+
+avr_irq_t *pinIrq(avr_t *avr, int pin) {
+  char port = pin < 8 ? 'D' : pin < 14 ? 'B' : 'C';
+  int bit = pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14;
+  return avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), bit);
+}
+
+/** Pulls the pin up like the board does, so INPUT_PULLUP and idle serial lines read high. */
+void pullUp(avr_t *avr, int pin) {
+  char port = pin < 8 ? 'D' : pin < 14 ? 'B' : 'C';
+  int bit = pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14;
+  avr_ioport_external_t ext;
+  ext.name = port;
+  ext.mask = 1 << bit;
+  ext.value = 1 << bit;
+  avr_ioctl(avr, AVR_IOCTL_IOPORT_SET_EXTERNAL(port), &ext);
+  avr_raise_irq(pinIrq(avr, pin), 1);
+}
+
+bool readBudget(const char *path, std::map<std::string, avr_cycle_count_t> &budget) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char name[200];
+    unsigned long long cycles;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%199s %llu", name, &cycles) == 2) budget[name] = cycles;
+  }
+  fclose(f);
+  return true;
+}
+
+bool writeBudget(const char *path, const Probes &probes) {
+  FILE *f = fopen(path, "w");
+  if (!f) return false;
+  fprintf(f, "# max cycles per section, measured max plus 10%%\n");
+  for (std::map<uint8_t, Section>::const_iterator it = probes.sections.begin(); it != probes.sections.end(); ++it) {
+    fprintf(f, "%s %llu\n", probeName(it->first).c_str(), (unsigned long long)(it->second.max * 11 / 10));
+  }
+  fclose(f);
+  return true;
+}
+
+void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [--shots N] [--shot-interval MS] [--press MS] [--reload-every N] [--budget FILE] "
+          "[--write-budget FILE] firmware.elf\n",
+          name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 20;
+  unsigned long shotInterval = 2000;
+  unsigned long pressTime = 250;
+  unsigned long reloadEvery = 5;
+  const char *budgetPath = 0;
+  const char *writeBudgetPath = 0;
+  const char *elfPath = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--reload-every") && i + 1 < argc) {
+      reloadEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+      budgetPath = argv[++i];
+    } else if (!strcmp(argv[i], "--write-budget") && i + 1 < argc) {
+      writeBudgetPath = argv[++i];
+    } else if (argv[i][0] != '-' && !elfPath) {
+      elfPath = argv[i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (!elfPath || shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(elfPath, &firmware) != 0) {
+    fprintf(stderr, "can't read %s\n", elfPath);
+    return 1;
+  }
+  // arduino builds don't carry the .mmcu section
+  if (!firmware.mmcu[0]) strcpy(firmware.mmcu, "atmega328p");
+  if (!firmware.frequency) firmware.frequency = F_CPU;
+
+  avr_t *avr = avr_make_mcu_by_name(firmware.mmcu);
+  if (!avr) {
+    fprintf(stderr, "simavr has no core for %s\n", firmware.mmcu);
+    return 1;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+
+  Probes probes;
+  avr_register_io_write(avr, GPIOR0_ADDR, probeWritten, &probes);
+  pullUp(avr, VOICE_RX_PIN);
+  pullUp(avr, AUDIO_RX_PIN);
+  pullUp(avr, TRIGGER_PIN);
+  pullUp(avr, RELOAD_PIN);
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  avr_raise_irq(pinIrq(avr, TRIGGER_PIN), 0);
+  int state = cpu_Running;
+  while (!probes.mainLoopSeen && avr->cycle < STARTUP_LIMIT && state != cpu_Done && state != cpu_Crashed) {
+    state = avr_run(avr);
+  }
+  avr_raise_irq(pinIrq(avr, TRIGGER_PIN), 1);
+  if (!probes.mainLoopSeen) {
+    fprintf(stderr, "the main loop never ran, was the sketch built with ENABLE_BENCH=1?\n");
+    return 1;
+  }
+  avr_cycle_count_t startupCycles = avr->cycle;
+
+  std::vector<Edge> edges;
+  avr_cycle_count_t t = avr->cycle;
+  for (unsigned long i = 0; i < shots; i++) {
+    t += shotInterval * MS;
+    edges.push_back(Edge{t, TRIGGER_PIN, 0});
+    edges.push_back(Edge{t + pressTime * MS, TRIGGER_PIN, 1});
+    if (reloadEvery && (i + 1) % reloadEvery == 0) {
+      t += shotInterval * MS;
+      edges.push_back(Edge{t, RELOAD_PIN, 0});
+      edges.push_back(Edge{t + pressTime * MS, RELOAD_PIN, 1});
+    }
+  }
+  avr_cycle_count_t end = t + shotInterval * MS;
+
+  size_t next = 0;
+  while (avr->cycle < end && state != cpu_Done && state != cpu_Crashed) {
+    while (next < edges.size() && avr->cycle >= edges[next].at) {
+      avr_raise_irq(pinIrq(avr, edges[next].pin), edges[next].level);
+      next++;
+    }
+    state = avr_run(avr);
+  }
+  if (state == cpu_Crashed) {
+    fprintf(stderr, "the firmware crashed at %.1f ms\n", avr->cycle / (double)MS);
+    return 1;
+  }
+
+  std::map<std::string, avr_cycle_count_t> budget;
+  if (budgetPath && !readBudget(budgetPath, budget)) {
+    fprintf(stderr, "can't read %s\n", budgetPath);
+    return 1;
+  }
+
+  printf("start up:        %.1f ms, %lu shots, reload every %lu\n", startupCycles / (double)MS, shots, reloadEvery);
+  printf("%-36s %7s %11s %11s %11s %9s\n", "section", "calls", "min cyc", "avg cyc", "max cyc", "max us");
+  int over = 0;
+  for (std::map<uint8_t, Section>::const_iterator it = probes.sections.begin(); it != probes.sections.end(); ++it) {
+    const Section &s = it->second;
+    std::string name = probeName(it->first);
+    std::map<std::string, avr_cycle_count_t>::const_iterator b = budget.find(name);
+    bool isOver = b != budget.end() && s.max > b->second;
+    printf("%-36s %7lu %11llu %11llu %11llu %9.1f%s\n", name.c_str(), s.calls, (unsigned long long)s.min,
+           (unsigned long long)(s.total / s.calls), (unsigned long long)s.max, s.max * 1000000.0 / F_CPU,
+           isOver ? "  over budget" : "");
+    if (isOver) over++;
+  }
+  for (std::map<std::string, avr_cycle_count_t>::const_iterator b = budget.begin(); b != budget.end(); ++b) {
+    bool seen = false;
+    for (std::map<uint8_t, Section>::const_iterator it = probes.sections.begin(); it != probes.sections.end(); ++it) {
+      if (probeName(it->first) == b->first) seen = true;
+    }
+    if (!seen) printf("%-36s never ran\n", b->first.c_str());
+  }
+  if (probes.unmatched) printf("unmatched probes: %lu\n", probes.unmatched);
+
+  if (writeBudgetPath && !writeBudget(writeBudgetPath, probes)) {
+    fprintf(stderr, "can't write %s\n", writeBudgetPath);
+    return 1;
+  }
+  if (over) {
+    printf("%d sections over budget\n", over);
+    return 1;
+  }
+  return 0;
+}
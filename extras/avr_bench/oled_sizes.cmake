@@ -0,0 +1,47 @@
+# Builds the sketch with every EasyOLED transport and buffer policy (see
+# easyoledpolicy.h) and lists the flash and RAM each build takes, from the
+# size report arduino-cli prints. A build that doesn't fit the board fails
+# and is listed as such.
+#
+# cmake -DARDUINO_CLI=arduino-cli -DFQBN=arduino:avr:nano -DSKETCH_DIR=dredd-lawgiver
+#       -DBUILD_DIR=build-avr/oled_sizes -P extras/avr_bench/oled_sizes.cmake
+foreach(var ARDUINO_CLI FQBN SKETCH_DIR BUILD_DIR)
+  if(NOT ${var})
+    message(FATAL_ERROR "${var} is not set")
+  endif()
+endforeach()
+
+set(TRANSPORTS OledSwSpi OledHwSpi OledHwI2c OledSwI2c)
+set(BUFFERS OledPage1 OledPage2 OledFull)
+
+message("transport\tbuffer\tflash\tRAM")
+foreach(transport ${TRANSPORTS})
+  set(flags "-DOLED_TRANSPORT=${transport}")
+  # hardware SPI needs the pin map that frees the SPI port
+  if(transport STREQUAL "OledHwSpi")
+    string(APPEND flags " -DENABLE_OLED_HW_SPI=1")
+  endif()
+  foreach(buffer ${BUFFERS})
+    execute_process(
+      COMMAND ${ARDUINO_CLI} compile --fqbn ${FQBN}
+              --build-property "compiler.cpp.extra_flags=${flags} -DOLED_BUFFER=${buffer}"
+              --build-path ${BUILD_DIR}/${transport}_${buffer} ${SKETCH_DIR}
+      OUTPUT_VARIABLE out
+      ERROR_VARIABLE err
+      RESULT_VARIABLE rc)
+    string(REGEX MATCH "Sketch uses ([0-9]+) bytes" flash "${out}")
+    set(flash ${CMAKE_MATCH_1})
+    string(REGEX MATCH "Global variables use ([0-9]+) bytes" ram "${out}")
+    set(ram ${CMAKE_MATCH_1})
+    if(NOT rc EQUAL 0)
+      if(err MATCHES "not enough memory|exceeds available space|too big")
+        message("${transport}\t${buffer}\tdoesn't fit")
+      else()
+        message("${transport}\t${buffer}\tbuild failed")
+        message("${err}")
+      endif()
+    else()
+      message("${transport}\t${buffer}\t${flash}\t${ram}")
+    endif()
+  endforeach()
+endforeach()
@@ -0,0 +1,78 @@
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+
+#include "config.h"
+#include "easyaudio.h"
+#include "easybutton.h"
+
+#include "firmware_timers.h"
+
+// globals from main.cpp
+extern EasyAudio audio;
+extern EasyButton trigger;
+extern EasyButton reload;
+extern uint8_t loopStage;
+extern unsigned long lastDisplayUpdate;
+extern unsigned long lastBlinkUpdate;
+extern volatile uint8_t activateLowAmmo;
+extern volatile unsigned long lowAmmoChangeTime;
+
+namespace {
+
+const long STARTUP_TIMINGS[] = {
+  TIMING_STARTUP_LOGO_MS,
+  TIMING_STARTUP_COMM_OK_MS,
+  TIMING_STARTUP_DNA_CHK_MS,
+  TIMING_STARTUP_DNA_PRG_MS,
+  TIMING_STARTUP_ID_OK_MS,
+  TIMING_STARTUP_ID_FAIL_MS,
+  TIMING_STARTUP_ID_NAME_MS,
+  TIMING_PROGRESS_INTERVAL_MS,
+};
+
+class FirmwareTimers : public sim::DeadlineSource {
+public:
+  unsigned long millisUntilDeadline(unsigned long now) {
+    _now = now;
+    _best = NO_DEADLINE;
+
+    // the firmware compares with "millis() > start + wait", so the first
+    // millis() value that passes is one past the sum
+    if (loopStage == LOOP_STATE_START) {
+      for (size_t i = 0; i < sizeof(STARTUP_TIMINGS) / sizeof(STARTUP_TIMINGS[0]); i++) {
+        consider(lastDisplayUpdate + STARTUP_TIMINGS[i] + 1);
+      }
+    }
+    consider(lastBlinkUpdate + TIMING_FAST_BLINK_WAIT_MS + 1);
+    if (activateLowAmmo) consider(lowAmmoChangeTime + TIMING_LOW_AMMO_WAIT_MS + 1);
+    consider(audio.busyUntil() + 1);
+    button(trigger);
+    button(reload);
+    return _best;
+  }
+
+private:
+  unsigned long _now;
+  unsigned long _best;
+
+  void consider(unsigned long at) {
+    unsigned long ms = (at - _now) & 0xFFFFFFFFUL;
+    if (ms != 0 && ms <= 0x7FFFFFFFUL && ms < _best) _best = ms;
+  }
+
+  void button(EasyButton &b) {
+    // ezButton keeps its debounce timer to itself, step through the settling
+    if (b.isSettling()) consider(_now + 1);
+    if (b.isPressing()) {
+      consider(b.pressedTime() + EasyButton::LONG_PRESS_TIME + 1);
+      consider(b.pressedTime() + TIMING_THEME_HOLD_MS + 1);
+    }
+  }
+};
+
+}  // namespace
+
+sim::DeadlineSource &firmwareTimers() {
+  static FirmwareTimers timers;
+  return timers;
+}
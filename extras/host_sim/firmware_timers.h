@@ -0,0 +1,20 @@
+#ifndef firmware_timers_h
+#define firmware_timers_h
+
+#include "sim.h"
+
+/**
+ * Deadline source for the timers the Lawgiver firmware keeps to itself: the
+ * start up sequence steps, the audio busy window, button debounce and hold
+ * times, the low ammo delay and the indicator blink.
+ *
+ * With it registered the virtual clock can jump an idle firmware straight to
+ * the next thing it is waiting for instead of stepping one millisecond at a
+ * time. EVERY_N_MILLISECONDS frame timers report themselves from the FastLED
+ * shim and don't need to be listed here.
+ *
+ * eg. sim::addDeadlineSource(&firmwareTimers());
+ */
+sim::DeadlineSource &firmwareTimers();
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/**
+ * Host replacement for the Arduino core used by the lawgiver sketch.
+ *
+ * Only the parts of the core that the sketch and the bundled libraries touch
+ * are provided. Pins, time and serial links are backed by the simulator in
+ * sim.h, so a test harness can drive inputs and observe outputs.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "avr/pgmspace.h"
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Arduino Nano pin map
+#define NUM_DIGITAL_PINS 20
+#define PIN_A0 (14)
+#define PIN_A1 (15)
+#define PIN_A2 (16)
+#define PIN_A3 (17)
+#define PIN_A4 (18)
+#define PIN_A5 (19)
+static const uint8_t A0 = PIN_A0;
+static const uint8_t A1 = PIN_A1;
+static const uint8_t A2 = PIN_A2;
+static const uint8_t A3 = PIN_A3;
+static const uint8_t A4 = PIN_A4;
+static const uint8_t A5 = PIN_A5;
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void noInterrupts(void);
+void interrupts(void);
+
+char* itoa(int value, char* str, int base);
+char* ltoa(long value, char* str, int base);
+char* utoa(unsigned int value, char* str, int base);
+
+#ifdef __cplusplus
+}  // extern "C"
+
+// The AVR core exposes these as macros; templates keep mixed types working
+// without clobbering std::min/std::max. They return by value: with two
+// arguments of the same type "a > b ? a : b" is a reference to a parameter.
+template<class A, class B>
+inline auto max(A a, B b) -> decltype(true ? A() : B()) { return a > b ? a : b; }
+template<class A, class B>
+inline auto min(A a, B b) -> decltype(true ? A() : B()) { return a < b ? a : b; }
+template<class T, class L, class H>
+inline T constrain(T amt, L low, H high) { return amt < low ? low : (amt > high ? high : amt); }
+
+// The BENCH probes in config.h write to GPIOR0; here the writes are handed to
+// sim::writeProbe() so a runner can time them on the virtual clock.
+struct ProbeRegister {
+  ProbeRegister &operator=(uint8_t value);
+};
+extern ProbeRegister GPIOR0;
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#endif
+
+#endif
@@ -0,0 +1,11 @@
+#include "FastLED.h"
+
+CLEDController *CLEDController::m_pHead = 0;
+CLEDController *CLEDController::m_pTail = 0;
+
+CFastLED FastLED;
+
+// Only referenced by the 2D blur helpers; sketches using a matrix provide their own.
+__attribute__((weak)) uint16_t XY(uint8_t x, uint8_t y) {
+  return 0;
+}
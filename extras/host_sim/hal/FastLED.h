@@ -0,0 +1,190 @@
+#ifndef __INC_FASTSPI_LED2_H
+#define __INC_FASTSPI_LED2_H
+
+/**
+ * Host replacement for FastLED.h.
+ *
+ * The color math (CRGB, lib8tion, colorutils, power management) comes from the
+ * bundled FastLED sources unchanged. Only the platform layer is replaced: the
+ * controller hands every frame to the simulator instead of bit-banging a pin.
+ *
+ * Defining the real header guards up front keeps the library's own
+ * #include "FastLED.h" lines from pulling in the AVR platform code.
+ */
+#define __INC_LED_SYSDEFS_H
+#define FASTLED_NAMESPACE_BEGIN
+#define FASTLED_NAMESPACE_END
+#define FASTLED_USING_NAMESPACE
+#define FASTLED_HAS_MILLIS 1
+#define CLKS_PER_US (F_CPU / 1000000)
+
+#include <Arduino.h>
+
+#include "FastLED/src/cpp_compat.h"
+#include "FastLED/src/fastled_config.h"
+#include "FastLED/src/fastled_progmem.h"
+#include "FastLED/src/lib8tion.h"
+#include "FastLED/src/pixeltypes.h"
+#include "FastLED/src/hsv2rgb.h"
+#include "FastLED/src/colorutils.h"
+#include "FastLED/src/power_mgt.h"
+
+#include "sim.h"
+
+/**
+ * EVERY_N_MILLISECONDS timer that tells the virtual clock when it is next
+ * due, so an idle poll can jump right up to the next animation frame. The
+ * wake up is booked on every check, including the one that fires, since the
+ * next poll of millis() may come before the timer is looked at again.
+ */
+class CSimEveryNMillis : public CEveryNMillis {
+public:
+  CSimEveryNMillis(uint32_t period) : CEveryNMillis(period) {}
+  operator bool() {
+    bool isReady = ready();
+    sim::wakeAtMillis((uint32_t)(mPrevTrigger + mPeriod));
+    return isReady;
+  }
+};
+
+#undef EVERY_N_MILLIS_I
+#define EVERY_N_MILLIS_I(NAME, N) static CSimEveryNMillis NAME(N); if (NAME)
+
+/** Chipset tag, only used to select the template overload below. */
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2812 {};
+
+/** Stand-in for the FastLED pin helper used by the power indicator LED. */
+class Pin {
+  uint8_t _pin;
+public:
+  Pin(int pin) : _pin(pin) {}
+  void hi() { digitalWrite(_pin, HIGH); }
+  void lo() { digitalWrite(_pin, LOW); }
+};
+
+/**
+ * Host LED controller. Keeps the same linked list as the real CLEDController
+ * so the bundled power_mgt.cpp can walk it.
+ *
+ * Timing follows the AVR ClocklessController in clockless_trinket.h for a
+ * WS2812 at 16 MHz: wait out the 10 us latch gap, then clock the whole strip
+ * out with interrupts off, 20 cycles per bit plus about 0.6 us of overhead
+ * per pixel.
+ */
+class CLEDController {
+  static const unsigned long LATCH_MICROS = 10;       // CMinWait<WAIT_TIME>
+  static const unsigned long CLKS_PER_BIT = 4 + 10 + 6;  // T1 + T2 + T3 at 16 MHz
+  unsigned long long m_lastShow = 0;
+
+protected:
+  CRGB *m_Data = 0;
+  int m_nLeds = 0;
+  uint8_t m_pin;
+  EOrder m_order;
+  CLEDController *m_pNext = 0;
+  static CLEDController *m_pHead;
+  static CLEDController *m_pTail;
+
+public:
+  CLEDController(uint8_t pin, EOrder order) : m_pin(pin), m_order(order) {
+    if (m_pHead == 0) m_pHead = this;
+    if (m_pTail != 0) m_pTail->m_pNext = this;
+    m_pTail = this;
+  }
+
+  void setLeds(CRGB *data, int nLeds) {
+    m_Data = data;
+    m_nLeds = nLeds;
+  }
+
+  /** Time the strip is clocked out for, same estimate FastLED uses to fix up millis(). */
+  unsigned long frameMicros() const {
+    return (unsigned long)m_nLeds * (24 * CLKS_PER_BIT / CLKS_PER_US) + scale16by8(m_nLeds, (0.6 * 256) + 1);
+  }
+
+  void showLeds(uint8_t brightness) {
+    unsigned long long since = sim::elapsedMicros() - m_lastShow;
+    if (m_lastShow && since < LATCH_MICROS) sim::consumeMicros(LATCH_MICROS - since);
+    noInterrupts();
+    sim::consumeMicros(frameMicros());
+    sim::showLedFrame(m_pin, (const uint8_t *)m_Data, m_nLeds, m_order, brightness);
+    interrupts();
+    m_lastShow = sim::elapsedMicros();
+  }
+
+  CRGB *leds() { return m_Data; }
+  int size() { return m_nLeds; }
+  uint8_t pin() { return m_pin; }
+  CLEDController *next() { return m_pNext; }
+  static CLEDController *head() { return m_pHead; }
+};
+
+typedef uint8_t (*power_func)(uint8_t scale, uint32_t data);
+
+/**
+ * Host version of the FastLED singleton. Mirrors the parts of CFastLED the
+ * sketch calls, including power limiting on show().
+ */
+class CFastLED {
+  uint8_t m_Scale = 255;
+  uint32_t m_nPowerData = 0xFFFFFFFF;
+  power_func m_pPowerFunc = 0;
+
+public:
+  template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+  CLEDController &addLeds(struct CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+    static CLEDController c(DATA_PIN, RGB_ORDER);
+    int nOffset = (nLedsIfOffset > 0) ? nLedsOrOffset : 0;
+    int nLeds = (nLedsIfOffset > 0) ? nLedsIfOffset : nLedsOrOffset;
+    c.setLeds(data + nOffset, nLeds);
+    return c;
+  }
+
+  void setBrightness(uint8_t scale) { m_Scale = scale; }
+  uint8_t getBrightness() { return m_Scale; }
+
+  inline void setMaxPowerInVoltsAndMilliamps(uint8_t volts, uint32_t milliamps) { setMaxPowerInMilliWatts(volts * milliamps); }
+  inline void setMaxPowerInMilliWatts(uint32_t milliwatts) {
+    m_pPowerFunc = &calculate_max_brightness_for_power_mW;
+    m_nPowerData = milliwatts;
+  }
+
+  void show(uint8_t scale) {
+    if (m_pPowerFunc) {
+      scale = (*m_pPowerFunc)(scale, m_nPowerData);
+    }
+    for (CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+      pCur->showLeds(scale);
+    }
+  }
+  void show() { show(m_Scale); }
+
+  void clear(bool writeData = false) {
+    if (writeData) showColor(CRGB(0, 0, 0), 0);
+    clearData();
+  }
+  void clearData() {
+    for (CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+      memset((void *)pCur->leds(), 0, sizeof(CRGB) * pCur->size());
+    }
+  }
+  void showColor(const struct CRGB &color, uint8_t scale) {
+    for (CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+      fill_solid(pCur->leds(), pCur->size(), color);
+      pCur->showLeds(scale);
+    }
+  }
+
+  void delay(unsigned long ms) {
+    unsigned long start = millis();
+    do {
+      show();
+      yield();
+    } while ((millis() - start) < ms);
+  }
+};
+
+extern CFastLED FastLED;
+
+#endif
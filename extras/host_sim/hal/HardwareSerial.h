@@ -0,0 +1,53 @@
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+
+/**
+ * Host version of the USB serial port. Everything printed by the sketch goes
+ * to stdout so debug builds can be inspected from a terminal.
+ *
+ * Once begin() has set a baud rate, bytes leave through a 64 byte buffer at
+ * that rate like they do on the Nano: printing is free until the buffer is
+ * full, then each byte waits for one to go out. receive() stands in for
+ * typing into the serial monitor.
+ */
+class HardwareSerial : public Stream {
+public:
+  static const int TX_BUFFER_SIZE = 64;
+
+  static const int RX_BUFFER_SIZE = 64;
+
+  void begin(unsigned long baud) { _baud = baud; }
+  void end() {}
+  int available() { return (_rxHead - _rxTail + RX_BUFFER_SIZE) % RX_BUFFER_SIZE; }
+  int read() {
+    if (_rxHead == _rxTail) return -1;
+    uint8_t c = _rx[_rxTail];
+    _rxTail = (_rxTail + 1) % RX_BUFFER_SIZE;
+    return c;
+  }
+  int peek() { return _rxHead == _rxTail ? -1 : _rx[_rxTail]; }
+  size_t write(uint8_t c);
+  using Print::write;
+  operator bool() { return true; }
+
+  /** Types a byte into the serial monitor, dropped when the buffer is full. */
+  void receive(uint8_t c) {
+    int next = (_rxHead + 1) % RX_BUFFER_SIZE;
+    if (next == _rxTail) return;
+    _rx[_rxHead] = c;
+    _rxHead = next;
+  }
+
+private:
+  unsigned long _baud = 0;
+  unsigned long long _txFree = 0;  // when the buffer is empty
+  uint8_t _rx[RX_BUFFER_SIZE];
+  int _rxHead = 0;
+  int _rxTail = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif
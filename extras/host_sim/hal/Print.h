@@ -0,0 +1,89 @@
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "avr/pgmspace.h"
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+/**
+ * Host version of the Arduino Print base class. Subclasses only need to
+ * implement write(uint8_t); everything else funnels through it.
+ */
+class Print {
+public:
+  virtual ~Print() {}
+
+  int getWriteError() { return _writeError; }
+  void clearWriteError() { setWriteError(0); }
+
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      if (write(*buffer++)) n++;
+      else break;
+    }
+    return n;
+  }
+  size_t write(const char *str) {
+    if (str == NULL) return 0;
+    return write((const uint8_t *)str, strlen(str));
+  }
+  size_t write(const char *buffer, size_t size) {
+    return write((const uint8_t *)buffer, size);
+  }
+  virtual void flush() {}
+
+  size_t print(const __FlashStringHelper *ifsh) { return write(reinterpret_cast<const char *>(ifsh)); }
+  size_t print(const char str[]) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = 10) { return printNumber(n, base); }
+  size_t print(int n, int base = 10) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = 10) { return printNumber(n, base); }
+  size_t print(long n, int base = 10) {
+    if (base == 10 && n < 0) {
+      size_t t = print('-');
+      return t + printNumber(-(unsigned long)n, 10);
+    }
+    return printNumber((unsigned long)n, base);
+  }
+  size_t print(unsigned long n, int base = 10) { return printNumber(n, base); }
+  size_t print(double n, int digits = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+  }
+
+  size_t println(void) { return write("\r\n"); }
+  template<typename T>
+  size_t println(T value) { size_t n = print(value); return n + println(); }
+  template<typename T>
+  size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+
+protected:
+  void setWriteError(int err = 1) { _writeError = err; }
+
+private:
+  int _writeError = 0;
+
+  size_t printNumber(unsigned long n, uint8_t base) {
+    char buf[8 * sizeof(long) + 1];
+    char *str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+      char c = n % base;
+      n /= base;
+      *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return write(str);
+  }
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include "Arduino.h"
+#include "sim.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+    : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock = 4000000;
+  uint8_t bitOrder = MSBFIRST;
+  uint8_t dataMode = SPI_MODE0;
+};
+
+/**
+ * Host version of the hardware SPI port. Bytes are timed at the configured
+ * clock and handed to whatever device model is attached.
+ */
+class SPIClass {
+public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings settings) { _settings = settings; }
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data);
+  void transfer(void *buf, size_t count) {
+    uint8_t *p = (uint8_t *)buf;
+    while (count--) {
+      *p = transfer(*p);
+      p++;
+    }
+  }
+  void setClockDivider(uint8_t) {}
+  void setDataMode(uint8_t mode) { _settings.dataMode = mode; }
+  void setBitOrder(uint8_t order) { _settings.bitOrder = order; }
+
+  // host-only
+  void attach(sim::SpiDevice *device) { _device = device; }
+
+private:
+  SPISettings _settings;
+  sim::SpiDevice *_device = 0;
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,173 @@
+#include "SoftwareSerial.h"
+
+SoftwareSerial *SoftwareSerial::active_object = 0;
+
+SoftwareSerial *&SoftwareSerial::ports() {
+  // function local so construction order of global ports doesn't matter
+  static SoftwareSerial *head = 0;
+  return head;
+}
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic)
+  : _receivePin(receivePin), _transmitPin(transmitPin) {
+  _nextPort = ports();
+  ports() = this;
+}
+
+SoftwareSerial::~SoftwareSerial() {
+  end();
+  for (SoftwareSerial **p = &ports(); *p; p = &(*p)->_nextPort) {
+    if (*p == this) {
+      *p = _nextPort;
+      break;
+    }
+  }
+}
+
+SoftwareSerial *SoftwareSerial::onPin(uint8_t receivePin) {
+  for (SoftwareSerial *p = ports(); p; p = p->_nextPort) {
+    if (p->_receivePin == receivePin) return p;
+  }
+  return 0;
+}
+
+void SoftwareSerial::begin(long speed) {
+  _baud = speed;
+  pinMode(_transmitPin, OUTPUT);
+  digitalWrite(_transmitPin, HIGH);
+  pinMode(_receivePin, INPUT_PULLUP);
+  listen();
+}
+
+bool SoftwareSerial::listen() {
+  if (active_object != this) {
+    if (active_object) active_object->stopListening();
+    _rxStats.flushed += (_receive_buffer_tail + _SS_MAX_RX_BUFF - _receive_buffer_head) % _SS_MAX_RX_BUFF;
+    _buffer_overflow = false;
+    _receive_buffer_head = _receive_buffer_tail = 0;
+    active_object = this;
+    return true;
+  }
+  return false;
+}
+
+bool SoftwareSerial::stopListening() {
+  if (active_object == this) {
+    active_object = 0;
+    return true;
+  }
+  return false;
+}
+
+void SoftwareSerial::end() {
+  stopListening();
+}
+
+int SoftwareSerial::read() {
+  if (!isListening()) return -1;
+  if (_receive_buffer_head == _receive_buffer_tail) return -1;
+  uint8_t d = _receive_buffer[_receive_buffer_head];
+  _receive_buffer_head = (_receive_buffer_head + 1) % _SS_MAX_RX_BUFF;
+  sim::markActivity();
+  return d;
+}
+
+int SoftwareSerial::available() {
+  if (!isListening()) return 0;
+  return (_receive_buffer_tail + _SS_MAX_RX_BUFF - _receive_buffer_head) % _SS_MAX_RX_BUFF;
+}
+
+int SoftwareSerial::peek() {
+  if (!isListening()) return -1;
+  if (_receive_buffer_head == _receive_buffer_tail) return -1;
+  return _receive_buffer[_receive_buffer_head];
+}
+
+size_t SoftwareSerial::write(uint8_t b) {
+  if (_baud == 0) {
+    setWriteError();
+    return 0;
+  }
+  // start bit, 8 data bits and a stop bit, sent with interrupts disabled
+  noInterrupts();
+  sim::consumeMicros(10000000UL / _baud);
+  interrupts();
+  sim::counters().serialTxBytes++;
+  if (_device) _device->receive(b);
+  return 1;
+}
+
+bool SoftwareSerial::inject(uint8_t b) {
+  sim::counters().serialRxBytes++;
+  sim::markInput();
+  if (!isListening()) {
+    sim::counters().serialRxDropped++;
+    _rxStats.dropped++;
+    _rxStats.deaf++;
+    return false;
+  }
+  uint8_t next = (_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF;
+  if (next == _receive_buffer_head) {
+    if (!_buffer_overflow) _rxStats.overflows++;
+    _buffer_overflow = true;
+    sim::counters().serialRxDropped++;
+    _rxStats.dropped++;
+    _rxStats.overflowed++;
+    return false;
+  }
+  _receive_buffer[_receive_buffer_tail] = b;
+  _receive_buffer_tail = next;
+  _rxStats.received++;
+  return true;
+}
+
+void SoftwareSerial::startReceive(uint8_t b) {
+  if (sim::interruptsEnabled()) {
+    receiveLate(b, 0);
+    return;
+  }
+  // the pin change flag is already set, this edge goes unnoticed
+  if (_startPending) {
+    sim::counters().serialRxBytes++;
+    sim::counters().serialRxDropped++;
+    _rxStats.missed++;
+    return;
+  }
+  _startPending = true;
+  _pendingByte = b;
+  _pendingSince = sim::elapsedMicros();
+}
+
+void SoftwareSerial::handlePendingInterrupts() {
+  unsigned long long now = sim::elapsedMicros();
+  for (SoftwareSerial *p = ports(); p; p = p->_nextPort) {
+    if (!p->_startPending) continue;
+    p->_startPending = false;
+    p->receiveLate(p->_pendingByte, now - p->_pendingSince);
+  }
+}
+
+void SoftwareSerial::receiveLate(uint8_t b, unsigned long long lateMicros) {
+  unsigned long long bitMicros = _baud ? 1000000ULL / _baud : 104;
+  // frame bit under the start bit check: 0 start, 1 - 8 data, 9 stop, then idle
+  unsigned long long pos = (lateMicros + bitMicros / 2) / bitMicros;
+  uint8_t value = b;
+  if (pos > 0) {
+    // only a low data bit passes for a start bit, the rest is read from there on
+    if (pos > 8 || ((b >> (pos - 1)) & 1)) {
+      sim::counters().serialRxBytes++;
+      sim::counters().serialRxDropped++;
+      _rxStats.missed++;
+      return;
+    }
+    value = 0;
+    for (int i = 0; i < 8; i++) {
+      unsigned long long bit = pos + 1 + i;
+      uint8_t level = bit <= 8 ? (b >> (bit - 1)) & 1 : 1;
+      value |= level << i;
+    }
+    _rxStats.corrupted++;
+  }
+  // the interrupt reads the rest of the frame, about nine and a half bits
+  sim::scheduleAfter(bitMicros * 19 / 2, [this, value]() { inject(value); });
+}
@@ -0,0 +1,102 @@
+#ifndef SoftwareSerial_h
+#define SoftwareSerial_h
+
+#include "Arduino.h"
+#include "sim.h"
+
+#ifndef _SS_MAX_RX_BUFF
+#define _SS_MAX_RX_BUFF 64  // RX buffer size, same as the AVR library
+#endif
+
+/**
+ * Host version of the AVR SoftwareSerial library.
+ *
+ * Keeps the behaviour the sketch depends on: a 64 byte receive buffer, the
+ * overflow flag, and the rule that only the most recently listening port
+ * receives anything. Transmitting a byte costs the same 10 bit times it
+ * would on the wire.
+ *
+ * Host-only extensions let a device model sit on the other end of the link:
+ *   attach()       - register the model that receives bytes sent by the sketch
+ *   inject()       - deliver a byte from the model to the sketch's RX pin
+ *   startReceive() - put a byte on the wire, starting with its start bit now
+ *
+ * startReceive() goes through the receive interrupt the way the AVR library
+ * does. With interrupts off the start bit edge waits until they come back on.
+ * recv() then checks for the start bit half a bit after it was entered, so a
+ * byte seen late lands shifted (corrupted) or not at all (missed), and a
+ * second start bit while one is still waiting is missed too.
+ */
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic = false);
+  ~SoftwareSerial();
+
+  void begin(long speed);
+  bool listen();
+  void end();
+  bool isListening() { return this == active_object; }
+  bool stopListening();
+  bool overflow() {
+    bool ret = _buffer_overflow;
+    if (ret) _buffer_overflow = false;
+    return ret;
+  }
+  int peek();
+
+  virtual size_t write(uint8_t byte);
+  virtual int read();
+  virtual int available();
+  virtual void flush() {}
+  operator bool() { return true; }
+
+  using Print::write;
+
+  // host-only
+  void attach(sim::SerialDevice *device) { _device = device; }
+  bool inject(uint8_t byte);
+  void startReceive(uint8_t byte);
+  uint8_t rxPin() const { return _receivePin; }
+  uint8_t txPin() const { return _transmitPin; }
+  long baud() const { return _baud; }
+  static SoftwareSerial *onPin(uint8_t receivePin);
+  /** Run receive interrupts held back while interrupts were off, sim.cpp calls this. */
+  static void handlePendingInterrupts();
+
+  /**
+   * What became of the bytes sent to this port.
+   */
+  struct RxStats {
+    unsigned long received;   // landed in the buffer, corrupted ones included
+    unsigned long corrupted;  // start bit seen late, landed with the wrong value
+    unsigned long missed;     // start bit never seen
+    unsigned long dropped;    // not listening or buffer full, the two below
+    unsigned long deaf;       // another port was listening
+    unsigned long overflowed; // buffer full
+    unsigned long overflows;  // times the overflow flag went up
+    unsigned long flushed;    // received but still unread when listen() started over
+  };
+  const RxStats &rxStats() const { return _rxStats; }
+
+private:
+  uint8_t _receivePin;
+  uint8_t _transmitPin;
+  long _baud = 0;
+  bool _buffer_overflow = false;
+  uint8_t _receive_buffer[_SS_MAX_RX_BUFF];
+  volatile uint8_t _receive_buffer_tail = 0;
+  volatile uint8_t _receive_buffer_head = 0;
+  sim::SerialDevice *_device = 0;
+  SoftwareSerial *_nextPort = 0;
+  RxStats _rxStats = {};
+  bool _startPending = false;       // start bit edge waiting for interrupts
+  uint8_t _pendingByte = 0;
+  unsigned long long _pendingSince = 0;
+
+  void receiveLate(uint8_t byte, unsigned long long lateMicros);
+
+  static SoftwareSerial *active_object;
+  static SoftwareSerial *&ports();
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+/**
+ * Host version of the Arduino Stream base class.
+ */
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+#endif
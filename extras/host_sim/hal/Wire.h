@@ -0,0 +1,31 @@
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+/**
+ * Host version of the I2C port. Nothing on the lawgiver uses I2C unless the
+ * OLED is given an I2C transport, so there is no device model behind it.
+ * Bytes, the address byte included, take 9 clocks at the configured speed.
+ */
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t clock) { _clock = clock; }
+  void beginTransmission(uint8_t address) { write(address); }
+  uint8_t endTransmission(bool stop = true) { return 0; }
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) { return 0; }
+  size_t write(uint8_t data);
+  using Print::write;
+  int available() { return 0; }
+  int read() { return -1; }
+  int peek() { return -1; }
+
+private:
+  uint32_t _clock = 100000;
+};
+
+extern TwoWire Wire;
+
+#endif
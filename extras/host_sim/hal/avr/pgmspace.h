@@ -0,0 +1,34 @@
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_
+
+/**
+ * Host replacement for avr-libc's program-space helpers. Flash and RAM share
+ * one address space on the host, so every accessor is a plain memory read.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)   (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)  (*(const uint32_t *)(addr))
+#define pgm_read_float(addr)  (*(const float *)(addr))
+#define pgm_read_ptr(addr)    (*(void * const *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+#define pgm_read_dword_near(addr) pgm_read_dword(addr)
+#define pgm_read_byte_far(addr)  pgm_read_byte(addr)
+
+#define memcpy_P  memcpy
+#define memcmp_P  memcmp
+#define strcmp_P  strcmp
+#define strncmp_P strncmp
+#define strcpy_P  strcpy
+#define strncpy_P strncpy
+#define strlen_P  strlen
+#define strcat_P  strcat
+
+#endif
@@ -0,0 +1,505 @@
+#include <chrono>
+#include <queue>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "SoftwareSerial.h"
+#include "Wire.h"
+#include "sim.h"
+
+/**
+ * Host implementation of the Arduino core, backed by the simulator state.
+ */
+namespace sim {
+
+static const uint8_t MAX_LISTENERS = 8;
+
+static Counters _counters;
+
+static uint8_t _pinMode[NUM_DIGITAL_PINS];
+static uint8_t _pinOutput[NUM_DIGITAL_PINS];
+static int _pinInput[NUM_DIGITAL_PINS];  // -1 when nothing drives the pin
+static int _pinLastRead[NUM_DIGITAL_PINS];  // last level digitalRead() returned
+
+static PinListener *_pinListeners[MAX_LISTENERS];
+static uint8_t _pinListenerCnt = 0;
+static LedListener *_ledListeners[MAX_LISTENERS];
+static uint8_t _ledListenerCnt = 0;
+static InterruptListener *_interruptListeners[MAX_LISTENERS];
+static uint8_t _interruptListenerCnt = 0;
+static ProbeListener *_probeListeners[MAX_LISTENERS];
+static uint8_t _probeListenerCnt = 0;
+
+static bool _interruptsOff = false;
+static unsigned long long _interruptsOffSince = 0;
+
+static std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+static ClockMode _clockMode = WALL_CLOCK;
+static unsigned long long _virtualMicros = 0;
+static unsigned long _startMillis = 0;
+static unsigned long _maxIdleStep = 1000;
+static bool _activity = true;  // something happened since the last millis() / micros()
+static uint8_t _quietPolls = 0;
+static unsigned long long _settleUntil = 0;
+static ClockStats _clockStats;
+
+// Reads of an unchanged clock, with nothing else going on, that make the
+// firmware idle. A pass through mainLoop() reads millis() about six times.
+static const uint8_t IDLE_POLLS = 16;
+
+// Longest the firmware busy waits on its own clock, EasyVR::receive() gives
+// up on a missing packet after 50 ms. Twice that covers both receive calls.
+static const unsigned long long SETTLE_MICROS = 100000ULL;
+
+struct Event {
+  unsigned long long at;
+  unsigned long seq;  // keeps events scheduled for the same time in order
+  std::function<void()> fn;
+};
+
+struct EventAfter {
+  bool operator()(const Event &a, const Event &b) const {
+    return a.at != b.at ? a.at > b.at : a.seq > b.seq;
+  }
+};
+
+static std::priority_queue<Event, std::vector<Event>, EventAfter> _events;
+static unsigned long _eventSeq = 0;
+static std::set<unsigned long long> _wakes;
+static DeadlineSource *_deadlineSources[MAX_LISTENERS];
+static uint8_t _deadlineSourceCnt = 0;
+
+static bool _pinsReady = false;
+
+static void initPins() {
+  if (_pinsReady) return;
+  for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++) {
+    _pinMode[i] = INPUT;
+    _pinOutput[i] = LOW;
+    _pinInput[i] = -1;
+    _pinLastRead[i] = -1;
+  }
+  _pinsReady = true;
+}
+
+Counters &counters() {
+  return _counters;
+}
+
+void resetCounters() {
+  memset(&_counters, 0, sizeof(_counters));
+}
+
+static unsigned long long wallMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+void setClockMode(ClockMode mode) {
+  _clockMode = mode;
+  _start = std::chrono::steady_clock::now();
+  _virtualMicros = 0;
+  _wakes.clear();
+}
+
+ClockMode clockMode() {
+  return _clockMode;
+}
+
+void setStartMillis(unsigned long ms) {
+  _startMillis = ms;
+}
+
+void setMaxIdleStep(unsigned long us) {
+  _maxIdleStep = us;
+}
+
+unsigned long long elapsedMicros() {
+  return _clockMode == VIRTUAL_CLOCK ? _virtualMicros : wallMicros();
+}
+
+/** millis() as the firmware sees it, 32 bits wide. */
+static unsigned long firmwareMillis(unsigned long long us) {
+  return (unsigned long)((_startMillis + us / 1000ULL) & 0xFFFFFFFFULL);
+}
+
+static void runEvents(unsigned long long until) {
+  while (!_events.empty() && _events.top().at <= until) {
+    Event e = _events.top();
+    _events.pop();
+    if (_clockMode == VIRTUAL_CLOCK && _virtualMicros < e.at) _virtualMicros = e.at;
+    _clockStats.events++;
+    _activity = true;
+    e.fn();
+  }
+}
+
+static void advanceTo(unsigned long long until) {
+  runEvents(until);
+  if (_virtualMicros < until) _virtualMicros = until;
+  _wakes.erase(_wakes.begin(), _wakes.upper_bound(_virtualMicros));
+}
+
+/**
+ * Called when the firmware keeps reading the time without doing anything
+ * else. Nothing can change until an event, a wake up or a reported deadline
+ * comes round, so go straight there.
+ */
+static void idleJump() {
+  const unsigned long long now = _virtualMicros;
+  unsigned long long target = _maxIdleStep ? now + _maxIdleStep : ~0ULL;
+  // an input just changed, step through the firmware's wait loops one
+  // millisecond at a time so it notices when it would on the board
+  if (now < _settleUntil && target > now + 1000) target = now + 1000;
+  if (!_events.empty() && _events.top().at < target) target = _events.top().at;
+  std::set<unsigned long long>::iterator wake = _wakes.upper_bound(now);
+  if (wake != _wakes.end() && *wake < target) target = *wake;
+  unsigned long nowMs = firmwareMillis(now);
+  for (uint8_t i = 0; i < _deadlineSourceCnt; i++) {
+    unsigned long ms = _deadlineSources[i]->millisUntilDeadline(nowMs);
+    if (ms == DeadlineSource::NO_DEADLINE || ms == 0) continue;
+    unsigned long long at = (now / 1000ULL + ms) * 1000ULL;
+    if (at < target) target = at;
+  }
+  // nothing pending at all, keep the clock ticking
+  if (target == ~0ULL) target = now + 1000;
+  if (target <= now) {
+    runEvents(now);
+    return;
+  }
+  _clockStats.jumps++;
+  _clockStats.idleMicros += target - now;
+  advanceTo(target);
+}
+
+/** Every read of the clock by the firmware comes through here. */
+static void poll() {
+  if (_clockMode == WALL_CLOCK) {
+    runEvents(wallMicros());
+    return;
+  }
+  if (_activity) {
+    _activity = false;
+    _quietPolls = 0;
+    return;
+  }
+  // one pass of loop() reads the clock a handful of times, a wait loop reads
+  // it over and over. Only jump once every timer has had its look.
+  if (++_quietPolls < IDLE_POLLS) return;
+  _quietPolls = 0;
+  idleJump();
+}
+
+void consumeMicros(unsigned long us) {
+  if (_clockMode == VIRTUAL_CLOCK) {
+    advanceTo(_virtualMicros + us);
+    _activity = true;
+    return;
+  }
+  unsigned long long until = wallMicros() + us;
+  while (wallMicros() < until) {
+  }
+  runEvents(wallMicros());
+}
+
+void advanceMicros(unsigned long long us) {
+  if (_clockMode == VIRTUAL_CLOCK) advanceTo(_virtualMicros + us);
+}
+
+void schedule(unsigned long long atMicros, std::function<void()> fn) {
+  Event e;
+  e.at = atMicros;
+  e.seq = _eventSeq++;
+  e.fn = fn;
+  _events.push(e);
+}
+
+void scheduleAfter(unsigned long long delayMicros, std::function<void()> fn) {
+  schedule(elapsedMicros() + delayMicros, fn);
+}
+
+void wakeAt(unsigned long long atMicros) {
+  if (_clockMode == VIRTUAL_CLOCK && atMicros > _virtualMicros) _wakes.insert(atMicros);
+}
+
+void wakeAtMillis(unsigned long ms) {
+  if (_clockMode != VIRTUAL_CLOCK) return;
+  unsigned long delta = (ms - firmwareMillis(_virtualMicros)) & 0xFFFFFFFFUL;
+  // already passed, or too far ahead to be anything but a wrapped value
+  if (delta == 0 || delta > 0x7FFFFFFFUL) return;
+  _wakes.insert((_virtualMicros / 1000ULL + delta) * 1000ULL);
+}
+
+void addDeadlineSource(DeadlineSource *source) {
+  if (_deadlineSourceCnt < MAX_LISTENERS) _deadlineSources[_deadlineSourceCnt++] = source;
+}
+
+void markActivity() {
+  _activity = true;
+}
+
+void markInput() {
+  _settleUntil = elapsedMicros() + SETTLE_MICROS;
+}
+
+const ClockStats &clockStats() {
+  return _clockStats;
+}
+
+void setInput(uint8_t pin, int level) {
+  initPins();
+  if (pin < NUM_DIGITAL_PINS) _pinInput[pin] = level;
+  markInput();
+}
+
+uint8_t outputLevel(uint8_t pin) {
+  initPins();
+  return pin < NUM_DIGITAL_PINS ? _pinOutput[pin] : LOW;
+}
+
+void addPinListener(PinListener *listener) {
+  if (_pinListenerCnt < MAX_LISTENERS) _pinListeners[_pinListenerCnt++] = listener;
+}
+
+void addLedListener(LedListener *listener) {
+  if (_ledListenerCnt < MAX_LISTENERS) _ledListeners[_ledListenerCnt++] = listener;
+}
+
+void addInterruptListener(InterruptListener *listener) {
+  if (_interruptListenerCnt < MAX_LISTENERS) _interruptListeners[_interruptListenerCnt++] = listener;
+}
+
+void addProbeListener(ProbeListener *listener) {
+  if (_probeListenerCnt < MAX_LISTENERS) _probeListeners[_probeListenerCnt++] = listener;
+}
+
+bool interruptsEnabled() {
+  return !_interruptsOff;
+}
+
+void showLedFrame(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) {
+  _counters.ledFrames++;
+  _activity = true;
+  for (uint8_t i = 0; i < _ledListenerCnt; i++) {
+    _ledListeners[i]->frameShown(pin, rgb, count, order, brightness);
+  }
+}
+
+void writeProbe(uint8_t value) {
+  for (uint8_t i = 0; i < _probeListenerCnt; i++) {
+    _probeListeners[i]->probeWritten(value);
+  }
+}
+
+void reset() {
+  _pinsReady = false;
+  initPins();
+  _pinListenerCnt = 0;
+  _ledListenerCnt = 0;
+  _interruptListenerCnt = 0;
+  _probeListenerCnt = 0;
+  _interruptsOff = false;
+  _deadlineSourceCnt = 0;
+  while (!_events.empty()) _events.pop();
+  _wakes.clear();
+  memset(&_clockStats, 0, sizeof(_clockStats));
+  _activity = true;
+  _quietPolls = 0;
+  _settleUntil = 0;
+  resetCounters();
+}
+
+}  // namespace sim
+
+HardwareSerial Serial;
+SPIClass SPI;
+TwoWire Wire;
+ProbeRegister GPIOR0;
+
+ProbeRegister &ProbeRegister::operator=(uint8_t value) {
+  sim::writeProbe(value);
+  return *this;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (_baud) {
+    unsigned long long byteTime = 10000000ULL / _baud;
+    unsigned long long now = sim::elapsedMicros();
+    if (_txFree < now) _txFree = now;
+    unsigned long long full = now + (TX_BUFFER_SIZE - 1) * byteTime;
+    if (_txFree > full) sim::consumeMicros(_txFree - full);
+    _txFree += byteTime;
+  }
+  fputc(c, stdout);
+  return 1;
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  // 8 clocks at the configured bus speed
+  sim::consumeMicros(8000000UL / _settings.clock);
+  sim::counters().spiBytes++;
+  if (_device) return _device->transfer(data);
+  return 0xFF;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  // 8 data bits and the ack
+  sim::consumeMicros(9000000UL / _clock);
+  return 1;
+}
+
+extern "C" {
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  sim::initPins();
+  if (pin < NUM_DIGITAL_PINS) sim::_pinMode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  sim::initPins();
+  if (pin >= NUM_DIGITAL_PINS) return;
+  sim::_counters.pinWrites++;
+  sim::_activity = true;
+  val = val ? HIGH : LOW;
+  if (sim::_pinOutput[pin] == val) return;
+  sim::_pinOutput[pin] = val;
+  for (uint8_t i = 0; i < sim::_pinListenerCnt; i++) {
+    sim::_pinListeners[i]->pinChanged(pin, val);
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  sim::initPins();
+  if (pin >= NUM_DIGITAL_PINS) return LOW;
+  int level;
+  if (sim::_pinInput[pin] >= 0) level = sim::_pinInput[pin] ? HIGH : LOW;
+  else if (sim::_pinMode[pin] == OUTPUT) level = sim::_pinOutput[pin];
+  else level = sim::_pinMode[pin] == INPUT_PULLUP ? HIGH : LOW;
+  // the firmware seeing an input change is something to react to
+  if (level != sim::_pinLastRead[pin]) {
+    sim::_pinLastRead[pin] = level;
+    sim::_activity = true;
+  }
+  return level;
+}
+
+int analogRead(uint8_t pin) {
+  return 0;
+}
+
+void analogWrite(uint8_t pin, int val) {
+  digitalWrite(pin, val >= 128 ? HIGH : LOW);
+}
+
+unsigned long millis(void) {
+  sim::poll();
+  return sim::firmwareMillis(sim::elapsedMicros());
+}
+
+unsigned long micros(void) {
+  sim::poll();
+  return (unsigned long)((sim::_startMillis * 1000ULL + sim::elapsedMicros()) & 0xFFFFFFFFULL);
+}
+
+void delay(unsigned long ms) {
+  if (sim::_clockMode == sim::VIRTUAL_CLOCK) {
+    sim::_clockStats.delayMicros += ms * 1000ULL;
+    sim::advanceTo(sim::_virtualMicros + ms * 1000ULL);
+    sim::_activity = true;
+    return;
+  }
+  unsigned long long until = sim::wallMicros() + ms * 1000ULL;
+  for (;;) {
+    unsigned long long now = sim::wallMicros();
+    if (now >= until) break;
+    // wake up for events that fall due during the delay
+    unsigned long long next = until;
+    if (!sim::_events.empty() && sim::_events.top().at < next) next = sim::_events.top().at;
+    if (next > now) std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+    sim::runEvents(sim::wallMicros());
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  sim::consumeMicros(us);
+}
+
+void yield(void) {
+}
+
+// Like cli() / sei() these don't nest, the first interrupts() ends the blackout.
+void noInterrupts(void) {
+  if (sim::_interruptsOff) return;
+  sim::_interruptsOff = true;
+  sim::_interruptsOffSince = sim::elapsedMicros();
+}
+
+void interrupts(void) {
+  if (!sim::_interruptsOff) return;
+  sim::_interruptsOff = false;
+  unsigned long long start = sim::_interruptsOffSince;
+  unsigned long us = (unsigned long)(sim::elapsedMicros() - start);
+  // a receive interrupt held back by the blackout runs first
+  SoftwareSerial::handlePendingInterrupts();
+  sim::_counters.blackouts++;
+  sim::_counters.blackoutMicros += us;
+  if (us > sim::_counters.longestBlackoutMicros) sim::_counters.longestBlackoutMicros = us;
+  for (uint8_t i = 0; i < sim::_interruptListenerCnt; i++) {
+    sim::_interruptListeners[i]->interruptsBlocked(start, us);
+  }
+}
+
+static char *unsignedToString(unsigned long value, char *str, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if (base < 2 || base > 36) base = 10;
+  do {
+    int d = value % base;
+    value /= base;
+    *--p = d < 10 ? '0' + d : 'a' + d - 10;
+  } while (value);
+  strcpy(str, p);
+  return str;
+}
+
+char *ltoa(long value, char *str, int base) {
+  if (value < 0 && base == 10) {
+    str[0] = '-';
+    unsignedToString(-(unsigned long)value, str + 1, base);
+    return str;
+  }
+  return unsignedToString((unsigned long)value, str, base);
+}
+
+char *itoa(int value, char *str, int base) {
+  if (base != 10) return unsignedToString((unsigned int)value, str, base);
+  return ltoa(value, str, base);
+}
+
+char *utoa(unsigned int value, char *str, int base) {
+  return unsignedToString(value, str, base);
+}
+
+}  // extern "C"
+
+long random(long howbig) {
+  if (howbig == 0) return 0;
+  return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) srand(seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
@@ -0,0 +1,243 @@
+#ifndef sim_h
+#define sim_h
+
+#include <stdint.h>
+#include <functional>
+
+/**
+ * Control surface of the host simulator.
+ *
+ * The Arduino shims in this directory route pins, time, serial links and LED
+ * frames through here. A harness uses the same functions to drive inputs
+ * (eg. pull the trigger pin low) and to attach device models that observe
+ * what the firmware sends.
+ *
+ * eg. sim::setInput(TRIGGER_PIN, LOW);
+ * eg. SoftwareSerial::onPin(AUDIO_RX_PIN)->attach(&player);
+ */
+namespace sim {
+
+/**
+ * Receives bytes the sketch writes to a serial port.
+ */
+class SerialDevice {
+public:
+  virtual ~SerialDevice() {}
+  virtual void receive(uint8_t b) = 0;
+};
+
+/**
+ * Sits on the hardware SPI port.
+ */
+class SpiDevice {
+public:
+  virtual ~SpiDevice() {}
+  virtual uint8_t transfer(uint8_t b) = 0;
+};
+
+/**
+ * Notified each time the sketch changes the level of an output pin.
+ */
+class PinListener {
+public:
+  virtual ~PinListener() {}
+  virtual void pinChanged(uint8_t pin, uint8_t level) = 0;
+};
+
+/**
+ * Notified each time FastLED pushes a frame out to a strip.
+ *   rgb        - pixel data in memory order (r, g, b), before brightness scaling
+ *   order      - FastLED EOrder of the strip
+ *   brightness - scale actually applied, after power limiting
+ */
+class LedListener {
+public:
+  virtual ~LedListener() {}
+  virtual void frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) = 0;
+};
+
+/**
+ * Notified each time the sketch turns interrupts back on, with when they went
+ * off and for how long. On the Nano nothing is serviced in that window: a
+ * SoftwareSerial start bit or a timer tick waits until it ends.
+ */
+class InterruptListener {
+public:
+  virtual ~InterruptListener() {}
+  virtual void interruptsBlocked(unsigned long long startMicros, unsigned long micros) = 0;
+};
+
+/**
+ * Notified of every write to GPIOR0, which is where a build with ENABLE_BENCH
+ * puts its BENCH probes (see config.h): the id on the way in, the id with the
+ * top bit set on the way out.
+ */
+class ProbeListener {
+public:
+  virtual ~ProbeListener() {}
+  virtual void probeWritten(uint8_t value) = 0;
+};
+
+/**
+ * Running totals for everything that crossed the simulated board's edge.
+ */
+struct Counters {
+  unsigned long pinWrites;
+  unsigned long serialTxBytes;
+  unsigned long serialRxBytes;
+  unsigned long serialRxDropped;
+  unsigned long spiBytes;
+  unsigned long ledFrames;
+  unsigned long blackouts;              // noInterrupts() / interrupts() pairs
+  unsigned long long blackoutMicros;    // time spent with interrupts off
+  unsigned long longestBlackoutMicros;
+};
+
+Counters &counters();
+void resetCounters();
+
+/**
+ * Where the simulated time comes from.
+ *   WALL_CLOCK    - millis() follows the host clock, delay() sleeps. Good for
+ *                   watching the firmware run at its real pace.
+ *   VIRTUAL_CLOCK - time only moves when the firmware spends it (delay(),
+ *                   bytes on a serial port, SPI clocks) or when it sits idle
+ *                   polling millis(). An idle poll jumps the clock straight to
+ *                   the next pending deadline, so hours replay in seconds.
+ *
+ * Switching modes restarts the clock at zero.
+ */
+enum ClockMode { WALL_CLOCK, VIRTUAL_CLOCK };
+
+void setClockMode(ClockMode mode);
+ClockMode clockMode();
+
+/**
+ * Value millis() reads when the clock is at zero. millis() and micros() wrap
+ * at 32 bits like they do on the Nano, so starting close to 0xFFFFFFFF puts
+ * the 49 day rollover inside a short run.
+ *
+ * eg. sim::setStartMillis(0xFFFFFFFFUL - 60000UL);  // wrap after a minute
+ */
+void setStartMillis(unsigned long ms);
+
+/**
+ * Microseconds since the simulation started.
+ */
+unsigned long long elapsedMicros();
+
+/**
+ * Account for time the CPU spends busy, eg. shifting a byte out of a
+ * SoftwareSerial port with interrupts off.
+ */
+void consumeMicros(unsigned long us);
+
+/**
+ * Move the clock forward from the harness side, running any events that fall
+ * due on the way. Has no effect in WALL_CLOCK mode.
+ */
+void advanceMicros(unsigned long long us);
+
+/**
+ * Run fn once the clock reaches the given time (microseconds since start).
+ * Events fire in time order from inside whatever the firmware is doing, the
+ * way a pin change or an incoming byte would on the board.
+ *
+ * eg. sim::schedule(sim::elapsedMicros() + 80000, []() { sim::setInput(TRIGGER_PIN, -1); });
+ */
+void schedule(unsigned long long atMicros, std::function<void()> fn);
+void scheduleAfter(unsigned long long delayMicros, std::function<void()> fn);
+
+/**
+ * Ask the virtual clock to stop at a time the firmware is waiting for. Wake
+ * ups only limit how far an idle poll may jump, nothing runs when they pass.
+ *   wakeAtMillis() takes a value on the firmware's millis() scale.
+ */
+void wakeAt(unsigned long long atMicros);
+void wakeAtMillis(unsigned long ms);
+
+/**
+ * Reports timers held inside the firmware so the virtual clock never jumps
+ * over one. Polled every time an idle poll is about to jump.
+ */
+class DeadlineSource {
+public:
+  static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL;
+  virtual ~DeadlineSource() {}
+  /**
+   * Milliseconds from now until the earliest millis() value the firmware is
+   * waiting for, or NO_DEADLINE. Deadlines that have passed are ignored.
+   */
+  virtual unsigned long millisUntilDeadline(unsigned long now) = 0;
+};
+
+void addDeadlineSource(DeadlineSource *source);
+
+/**
+ * Longest jump an idle poll may take when nothing closer is pending. The
+ * default of 1000 us keeps every millis() value visible to the firmware, so
+ * timers nobody reported still fire on time. 0 removes the cap and leaves the
+ * clock to the reported deadlines alone.
+ */
+void setMaxIdleStep(unsigned long us);
+
+/**
+ * Note that the firmware did something the clock should not skip over. The
+ * shims call this for pin, serial and LED traffic.
+ */
+void markActivity();
+
+/**
+ * Note that something outside the board changed an input. For a short while
+ * after, idle polls only step 1 ms at a time, so the wait loops inside the
+ * firmware (eg. EasyVR::receive() timing out) end when they would on the
+ * board and the change is picked up on the same loop pass. setInput() and
+ * SoftwareSerial::inject() call this.
+ */
+void markInput();
+
+/**
+ * How the virtual clock got to where it is.
+ */
+struct ClockStats {
+  unsigned long jumps;             // idle polls that moved the clock
+  unsigned long long idleMicros;   // time covered by those jumps
+  unsigned long long delayMicros;  // time spent in delay()
+  unsigned long events;            // scheduled events run
+};
+
+const ClockStats &clockStats();
+
+/**
+ * Drive an input pin from outside the board. Pass -1 to release the pin so it
+ * falls back to its pull-up.
+ */
+void setInput(uint8_t pin, int level);
+uint8_t outputLevel(uint8_t pin);
+
+void addPinListener(PinListener *listener);
+void addLedListener(LedListener *listener);
+void addInterruptListener(InterruptListener *listener);
+void addProbeListener(ProbeListener *listener);
+
+bool interruptsEnabled();
+
+/**
+ * Called by the FastLED shim for every controller on show().
+ */
+void showLedFrame(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness);
+
+/**
+ * Called for every write to GPIOR0.
+ */
+void writeProbe(uint8_t value);
+
+/**
+ * Drop all listeners, pin state, scheduled events and deadline sources.
+ * Counters are reset as well. The clock mode is kept.
+ */
+void reset();
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef _UTIL_CRC16_H_
+#define _UTIL_CRC16_H_
+
+/**
+ * Host replacement for avr-libc's CRC helpers, the same arithmetic as the
+ * C equivalents given in avr-libc's documentation.
+ */
+#include <stdint.h>
+
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t a) {
+  crc ^= a;
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (crc & 1)
+      crc = (crc >> 1) ^ 0xA001;
+    else
+      crc = (crc >> 1);
+  }
+  return crc;
+}
+
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data) {
+  data ^= (uint8_t)(crc & 0xFF);
+  data ^= data << 4;
+  return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+static inline uint8_t _crc8_ccitt_update(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (crc & 0x80)
+      crc = (crc << 1) ^ 0x07;
+    else
+      crc <<= 1;
+  }
+  return crc;
+}
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef WiringPrivate_h
+#define WiringPrivate_h
+
+// Host build: nothing private to expose beyond the core itself.
+#include "Arduino.h"
+
+#endif
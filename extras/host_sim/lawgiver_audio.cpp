@@ -0,0 +1,161 @@
+/**
+ * Audio timing runner for the Lawgiver firmware.
+ *
+ * Puts an emulated DFPlayer on the audio link, a Mini or a Pro depending on
+ * which back end the firmware was built for, and measures:
+ *  - how long setup() takes, most of it in EasyAudio::begin()
+ *  - trigger to sound latency: from the trigger going down to the module
+ *    starting the shot track, for --shots shots
+ *
+ * The module's boot, reply and play start delays can be overridden to see how
+ * the firmware copes with a slower or faster module.
+ *
+ * Usage: lawgiver_audio [--shots N] [--shot-interval MS] [--press MS]
+ *                       [--boot MS] [--reply MS] [--play-start MS] [--log]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+#ifdef ENABLE_EASY_AUDIO_PRO
+typedef DFPlayerProModel Player;
+static const char *PLAYER_NAME = "DFPlayer Pro";
+#else
+typedef DFPlayerMiniModel Player;
+static const char *PLAYER_NAME = "DFPlayer Mini";
+#endif
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+
+/** Times track starts against the last trigger pull. */
+class Latency : public DFPlayerModel::PlaybackListener {
+public:
+  bool log = false;
+  unsigned long long pressedAt = 0;
+  bool waiting = false;
+  unsigned long count = 0;
+  unsigned long long total = 0;
+  unsigned long long min = ~0ULL;
+  unsigned long long max = 0;
+
+  void trackStarted(int track) {
+    unsigned long long now = sim::elapsedMicros();
+    if (log) printf("%10.1f ms  track %d started\n", now / 1000.0, track);
+    if (!waiting) return;
+    waiting = false;
+    unsigned long long us = now - pressedAt;
+    count++;
+    total += us;
+    if (us < min) min = us;
+    if (us > max) max = us;
+  }
+  void trackStopped(int track, bool finished) {
+    if (log) printf("%10.1f ms  track %d %s\n", sim::elapsedMicros() / 1000.0, track, finished ? "finished" : "cut off");
+  }
+};
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS] [--press MS] [--boot MS] [--reply MS] [--play-start MS] [--log]\n",
+          name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 10;
+  unsigned long shotInterval = 2000;
+  unsigned long pressTime = 250;
+  DFPlayerModel::Timing timing = Player::DEFAULT_TIMING;
+  Latency latency;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--boot") && i + 1 < argc) {
+      timing.boot = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--reply") && i + 1 < argc) {
+      timing.reply = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--play-start") && i + 1 < argc) {
+      timing.playStart = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--log")) {
+      latency.log = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  // the module powers up with the board
+  Player player(AUDIO_RX_PIN, timing);
+  player.setPlaybackListener(&latency);
+  if (!player.attach()) {
+    fprintf(stderr, "no serial port on pin %d\n", AUDIO_RX_PIN);
+    return 1;
+  }
+
+  setup();
+  unsigned long long setupUs = sim::elapsedMicros();
+  if (loopStage == LOOP_STATE_ERROR) {
+    fprintf(stderr, "setup failed after %.1f ms, the firmware gave up on the %s\n", setupUs / 1000.0, PLAYER_NAME);
+    return 1;
+  }
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  unsigned long long startupUs = sim::elapsedMicros() - setupUs;
+
+  for (unsigned long i = 0; i < shots; i++) {
+    latency.pressedAt = sim::elapsedMicros();
+    latency.waiting = true;
+    sim::setInput(TRIGGER_PIN, LOW);
+    sim::scheduleAfter(pressTime * MS, []() { sim::setInput(TRIGGER_PIN, -1); });
+    unsigned long long end = sim::elapsedMicros() + shotInterval * MS;
+    while (sim::elapsedMicros() < end) loop();
+  }
+
+  const DFPlayerModel::Stats &s = player.stats();
+  printf("module:          %s, boot %lu ms, reply %lu ms, play start %lu ms\n", PLAYER_NAME, timing.boot, timing.reply,
+         timing.playStart);
+  printf("setup:           %10.1f ms\n", setupUs / 1000.0);
+  printf("start up:        %10.1f ms\n", startupUs / 1000.0);
+  printf("commands:        %lu understood, %lu ignored while booting, %lu bad\n", s.commands, s.ignored, s.badCommands);
+  printf("tracks:          %lu started, %lu finished, %lu cut off\n", s.tracksStarted, s.tracksFinished, s.tracksCut);
+  printf("volume:          %u\n", player.volume());
+  if (latency.count) {
+    printf("trigger to sound: %lu of %lu shots, min %.1f ms, avg %.1f ms, max %.1f ms\n", latency.count, shots,
+           latency.min / 1000.0, latency.total / 1000.0 / latency.count, latency.max / 1000.0);
+  } else {
+    printf("trigger to sound: no shot was heard\n");
+  }
+  return latency.count == shots ? 0 : 1;
+}
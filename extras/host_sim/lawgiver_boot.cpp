@@ -0,0 +1,92 @@
+/**
+ * Boot time of the Lawgiver firmware, stage by stage.
+ *
+ * Powers the sketch up on the virtual clock with an audio player and a VR3
+ * on the serial links, holds the trigger through the start up sequence so the
+ * DNA check passes, and reports when the main loop started. The firmware is
+ * built with ENABLE_DEBUG and ENABLE_BOOT_TIMES, and once it's up the runner
+ * types 'b' into the debug port, the same command that works from a serial
+ * monitor on the prop, so the firmware prints when each stage ended:
+ *
+ *   lawgiver_boot | tail -14
+ *
+ * lawgiver_fastboot runs the same with ENABLE_FAST_BOOT, and the _pro builds
+ * with the DFPlayer Pro. The run fails when the main loop starts later than
+ * --budget ms after power on.
+ *
+ * Usage: lawgiver_boot [--budget MS]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+#ifdef ENABLE_EASY_AUDIO_PRO
+typedef DFPlayerProModel Player;
+#else
+typedef DFPlayerMiniModel Player;
+#endif
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--budget MS]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long budget = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+      budget = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  Player player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  setup();
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  unsigned long long up = sim::elapsedMicros();
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  // the next pass through the main loop answers
+  Serial.receive('b');
+  loop();
+  fflush(stdout);
+  printf("main loop after %.1f ms", up / 1000.0);
+  if (budget) printf(", budget %lu ms", budget);
+  printf("\n");
+  return budget && up > budget * MS ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * CPU time of the ammo counters on the host.
+ *
+ * Builds EasyOLED on a transport that drops every byte, so nothing is
+ * charged for the bus, and times the main screen redraws a shot and an ammo
+ * change cause, on the host's own clock. Built as lawgiver_counters, which
+ * draws the counters from the font, and as lawgiver_counters_labels with
+ * ENABLE_OLED_COUNTERS, which puts them together from the atlas made by
+ * labelgen, with the labels, battery and grid copied as well. The times include computing the CRC of each row and U8g2
+ * expanding it for the SH1122, which both builds do alike.
+ *
+ * The host is not a Nano, only the ratio between the two builds means
+ * anything; extras/avr_bench counts AVR cycles.
+ *
+ * Usage: lawgiver_counters [--shots N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include <Arduino.h>
+#include "config.h"
+#include "easyoled.h"
+
+namespace {
+
+/** U8g2 on no bus at all. */
+struct OledNullBus {
+  static const uint32_t BUS_CLOCK = 8000000;
+  template<class BUFFER>
+  static void setup(u8g2_t *u8g2, const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t cs, uint8_t dc, uint8_t reset) {
+    BUFFER::setupSpi(u8g2, rotation, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+typedef EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN, OledNullBus> Oled;
+
+double nsSince(std::chrono::steady_clock::time_point start, long count) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  long shots = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = atol(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--shots N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Oled *oled = new Oled();
+  uint8_t counts[4] = {25, 25, 25, 50};
+  oled->begin(VR_CMD_AMMO_MODE_FMJ, counts);
+  oled->updateDisplayMode(Oled::DISPLAY_MAIN, 0);
+  oled->updateDisplay(VR_CMD_AMMO_MODE_FMJ, counts);
+
+  // a count that goes down from 50 and back, every shot sends the counter rows
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (long i = 0; i < shots; i++) {
+    counts[3] = 50 - i % 46;
+    oled->updateDisplay(VR_CMD_AMMO_MODE_FMJ, counts);
+  }
+  double shotNs = nsSince(start, shots);
+
+  // switching ammo also redraws the name line
+  const int modes[] = {VR_CMD_AMMO_MODE_AP, VR_CMD_AMMO_MODE_IN, VR_CMD_AMMO_MODE_HE, VR_CMD_AMMO_MODE_FMJ};
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < shots; i++) oled->updateDisplay(modes[i % 4], counts);
+  double changeNs = nsSince(start, shots);
+
+  delete oled;
+  printf("counters from the %s\n", ENABLE_OLED_COUNTERS == 1 ? "atlas" : "font");
+  printf("shot redraw      %8.0f ns\n", shotNs);
+  printf("ammo change      %8.0f ns\n", changeNs);
+  return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * Host runner for the Lawgiver firmware.
+ *
+ * Runs setup(), walks the start up sequence (holding the trigger down so the
+ * DNA check passes), then runs the main loop while pulling the trigger at a
+ * fixed cadence. Reports how long each stage took and the loop latency.
+ *
+ * Usage: lawgiver_host [--loops N] [--shot-interval MS] [--press MS]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+namespace {
+
+struct LoopStats {
+  unsigned long count = 0;
+  unsigned long long total = 0;
+  unsigned long min = 0xFFFFFFFF;
+  unsigned long max = 0;
+
+  void add(unsigned long us) {
+    count++;
+    total += us;
+    if (us < min) min = us;
+    if (us > max) max = us;
+  }
+  unsigned long avg() const { return count ? (unsigned long)(total / count) : 0; }
+};
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--loops N] [--shot-interval MS] [--press MS]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long loops = 20000;
+  unsigned long shotInterval = 500;
+  unsigned long pressTime = 80;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--loops") && i + 1 < argc) {
+      loops = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  unsigned long long t0 = sim::elapsedMicros();
+  setup();
+  unsigned long long setupUs = sim::elapsedMicros() - t0;
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  t0 = sim::elapsedMicros();
+  LoopStats startup;
+  while (loopStage == LOOP_STATE_START) {
+    unsigned long long s = sim::elapsedMicros();
+    loop();
+    startup.add((unsigned long)(sim::elapsedMicros() - s));
+  }
+  unsigned long long startupUs = sim::elapsedMicros() - t0;
+  sim::setInput(TRIGGER_PIN, -1);
+
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  sim::resetCounters();
+  LoopStats main;
+  unsigned long presses = 0;
+  unsigned long nextShot = millis() + shotInterval;
+  unsigned long release = 0;
+  t0 = sim::elapsedMicros();
+  for (unsigned long i = 0; i < loops; i++) {
+    unsigned long now = millis();
+    if (release && now >= release) {
+      sim::setInput(TRIGGER_PIN, -1);
+      release = 0;
+    }
+    if (!release && now >= nextShot) {
+      sim::setInput(TRIGGER_PIN, LOW);
+      release = now + pressTime;
+      nextShot = now + shotInterval;
+      presses++;
+    }
+    unsigned long long s = sim::elapsedMicros();
+    loop();
+    main.add((unsigned long)(sim::elapsedMicros() - s));
+  }
+  unsigned long long mainUs = sim::elapsedMicros() - t0;
+
+  const sim::Counters &c = sim::counters();
+  printf("setup:           %10.1f ms\n", setupUs / 1000.0);
+  printf("startup:         %10.1f ms  (%lu loops, max %lu us)\n", startupUs / 1000.0, startup.count, startup.max);
+  printf("main loop:       %10.1f ms  (%lu loops, %.0f loops/s)\n", mainUs / 1000.0, main.count,
+         mainUs ? main.count * 1e6 / mainUs : 0.0);
+  printf("loop latency:    min %lu us, avg %lu us, max %lu us\n", main.min, main.avg(), main.max);
+  printf("trigger presses: %lu\n", presses);
+  printf("pin writes:      %lu\n", c.pinWrites);
+  printf("serial tx bytes: %lu\n", c.serialTxBytes);
+  printf("led frames:      %lu\n", c.ledFrames);
+  return 0;
+}
@@ -0,0 +1,198 @@
+/**
+ * Trigger-to-effect latency of the Lawgiver firmware, per ammo mode.
+ *
+ * Runs a build of the sketch with ENABLE_BENCH on the virtual clock, with a
+ * DFPlayer Mini and a VR3 on the serial links. The BENCH probes (see config.h)
+ * write to GPIOR0, which the simulator hands to this runner, so every interval
+ * is timed from the firmware's own marks rather than from the pins:
+ *   audio  BENCH_TRIGGER_PRESSED to the first BENCH_AUDIO_TX, the first byte
+ *          of the DFPlayerMini::sendData() command
+ *   leds   to the first BENCH_LED_SHOW, the first FastLED.show() of the shot
+ *          pattern (ezBlasterRepeatingShot for RAPID)
+ *   oled   to the end of the next main screen draw, the ammo count repaint
+ *
+ * After the start up sequence it selects each ammo mode in turn with
+ * changeAmmoMode(), the same call a voice command makes, reloads and fires
+ * --shots shots one every --shot-interval ms. Then it prints min, avg, p50,
+ * p90 and max in us for each mode and interval. A shot that got no answer
+ * before the next one is counted as missed.
+ *
+ * The simulator only charges time for what the firmware does on its pins and
+ * serial ports, not for the CPU, so the numbers are what the loop waits on.
+ * The frame timers restart with each shot, so a mode's shots mostly land on
+ * the same number; the spread comes from shots that catch the loop busy.
+ *
+ * Usage: lawgiver_latency [--shots N] [--shot-interval MS] [--press MS]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <Arduino.h>
+#include "config.h"
+#include "easyoled.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+typedef EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN> Oled;
+
+void setup(void);
+void loop(void);
+void changeAmmoMode(int mode);
+extern uint8_t loopStage;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long long SETTLE = 2000 * MS;   // after a mode change or a reload
+const unsigned long long NONE = ~0ULL;
+const uint8_t MODE_CNT = 7;
+const char *MODE_NAMES[MODE_CNT] = {"ap", "in", "hs", "he", "st", "fmj", "rapid"};
+
+const uint8_t INTERVAL_CNT = 3;
+const char *INTERVAL_NAMES[INTERVAL_CNT] = {"audio", "leds", "oled"};
+
+struct Shot {
+  unsigned long long pressed;
+  unsigned long long at[INTERVAL_CNT];
+};
+
+/** Stamps the firmware's marks onto the latest trigger press. */
+class Probes : public sim::ProbeListener {
+public:
+  std::vector<Shot> shots;
+  bool armed = false;  // only presses from the main loop count
+
+  void probeWritten(uint8_t value) {
+    unsigned long long now = sim::elapsedMicros();
+    if (value == BENCH_TRIGGER_PRESSED) {
+      if (!armed) return;
+      Shot s;
+      s.pressed = now;
+      for (uint8_t i = 0; i < INTERVAL_CNT; i++) s.at[i] = NONE;
+      shots.push_back(s);
+      return;
+    }
+    if (shots.empty()) return;
+    Shot &s = shots.back();
+    if (value == BENCH_AUDIO_TX) stamp(s, 0, now);
+    if (value == BENCH_LED_SHOW) stamp(s, 1, now);
+    if (value == ((BENCH_OLED_DRAW + Oled::DISPLAY_MAIN) | 0x80)) stamp(s, 2, now);
+  }
+
+private:
+  static void stamp(Shot &s, uint8_t interval, unsigned long long now) {
+    if (s.at[interval] == NONE) s.at[interval] = now;
+  }
+};
+
+void printInterval(const char *mode, const char *name, std::vector<unsigned long long> &us, size_t shots) {
+  printf("%-6s %-6s %4zu", mode, name, us.size());
+  if (us.empty()) {
+    printf("\n");
+    return;
+  }
+  std::sort(us.begin(), us.end());
+  unsigned long long total = 0;
+  for (size_t i = 0; i < us.size(); i++) total += us[i];
+  printf(" %8llu %8llu %8llu %8llu %8llu %6zu\n", us.front(), total / us.size(), us[us.size() / 2],
+         us[(us.size() * 9) / 10 < us.size() ? (us.size() * 9) / 10 : us.size() - 1], us.back(), shots - us.size());
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS] [--press MS]\n", name);
+}
+
+void press(uint8_t pin, unsigned long pressTime) {
+  sim::setInput(pin, LOW);
+  sim::scheduleAfter(pressTime * MS, [pin]() { sim::setInput(pin, -1); });
+}
+
+void runFor(unsigned long long us) {
+  unsigned long long end = sim::elapsedMicros() + us;
+  while (sim::elapsedMicros() < end) loop();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 10;
+  unsigned long shotInterval = 1500;
+  unsigned long pressTime = 100;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (!shots || shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+  Probes probes;
+  sim::addProbeListener(&probes);
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  runFor(SETTLE);
+
+  std::vector<Shot> byMode[MODE_CNT];
+  for (uint8_t mode = 0; mode < MODE_CNT; mode++) {
+    changeAmmoMode(mode);
+    runFor(SETTLE);
+    press(RELOAD_PIN, pressTime);
+    runFor(SETTLE);
+
+    probes.shots.clear();
+    probes.armed = true;
+    for (unsigned long i = 0; i < shots; i++) {
+      press(TRIGGER_PIN, pressTime);
+      runFor(shotInterval * MS);
+    }
+    probes.armed = false;
+    byMode[mode] = probes.shots;
+  }
+  fflush(stdout);
+
+  printf("\nmode   effect count   min us   avg us   p50 us   p90 us   max us missed\n");
+  for (uint8_t mode = 0; mode < MODE_CNT; mode++) {
+    const std::vector<Shot> &s = byMode[mode];
+    for (uint8_t i = 0; i < INTERVAL_CNT; i++) {
+      std::vector<unsigned long long> us;
+      for (size_t j = 0; j < s.size(); j++) {
+        if (s[j].at[i] != NONE) us.push_back(s[j].at[i] - s[j].pressed);
+      }
+      printInterval(MODE_NAMES[mode], INTERVAL_NAMES[i], us, shots);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * LED blackout runner for the Lawgiver firmware.
+ *
+ * Puts the WS2812 model on the fire LED pin, boots the firmware (trigger held
+ * so the DNA check passes), then fires --shots shots and a reload. For every
+ * pull it reports the frames the animation pushed and how long interrupts
+ * were off to clock them out, per frame and for the whole animation.
+ *
+ * A SoftwareSerial receiver finds a byte by its start bit edge. With
+ * interrupts off for more than half a bit the byte is sampled late and
+ * arrives corrupted, for longer than a whole byte one can be lost. Both
+ * limits are shown for the 9600 baud links to the DFPlayer Mini and the
+ * voice module.
+ *
+ * Usage: lawgiver_leds [--shots N] [--shot-interval MS]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "ws2812_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long PRESS_TIME = 250;
+const unsigned long HALF_BIT_MICROS = 1000000UL / 9600 / 2;
+const unsigned long BYTE_MICROS = 10000000UL / 9600;
+
+/** Collects the blackouts of one pull. */
+class Animation : public sim::InterruptListener {
+public:
+  WS2812Model *strip = 0;
+  unsigned long ledFrames = 0;
+  unsigned long overHalfBit = 0;
+  unsigned long overByte = 0;
+  unsigned long serialBlackouts = 0;
+
+  void start() {
+    ledFrames = overHalfBit = overByte = serialBlackouts = 0;
+    _lastFrames = strip->total().frames;
+  }
+  // listeners run in the order they were added, the strip claims its frames first
+  void interruptsBlocked(unsigned long long startMicros, unsigned long micros) {
+    if (strip->total().frames == _lastFrames) {
+      serialBlackouts++;
+      return;
+    }
+    _lastFrames = strip->total().frames;
+    ledFrames++;
+    if (micros > HALF_BIT_MICROS) overHalfBit++;
+    if (micros > BYTE_MICROS) overByte++;
+  }
+
+private:
+  unsigned long _lastFrames = 0;
+};
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 5;
+  unsigned long shotInterval = 2000;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (shotInterval <= PRESS_TIME) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  WS2812Model strip(FIRE_LED_PIN);
+  strip.attach();
+  Animation animation;
+  animation.strip = &strip;
+  sim::addInterruptListener(&animation);
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  WS2812Model::Stats boot = strip.total();
+  printf("start up: %lu frames, %.2f ms blackout, longest %lu us\n\n", boot.frames, boot.blackoutMicros / 1000.0,
+         boot.longestBlackoutMicros);
+
+  printf("pull     frames  blackout ms  us/frame  > half bit  > byte  serial blackouts\n");
+  for (unsigned long i = 0; i <= shots; i++) {
+    bool isReload = i == shots;
+    uint8_t pin = isReload ? RELOAD_PIN : TRIGGER_PIN;
+    WS2812Model::Stats before = strip.total();
+    animation.start();
+
+    sim::setInput(pin, LOW);
+    sim::scheduleAfter(PRESS_TIME * MS, [pin]() { sim::setInput(pin, -1); });
+    unsigned long long end = sim::elapsedMicros() + shotInterval * MS;
+    while (sim::elapsedMicros() < end) loop();
+
+    unsigned long frames = strip.total().frames - before.frames;
+    unsigned long long blackout = strip.total().blackoutMicros - before.blackoutMicros;
+    char name[16];
+    snprintf(name, sizeof(name), isReload ? "reload" : "shot %lu", i + 1);
+    printf("%-7s  %6lu  %11.2f  %8llu  %10lu  %6lu  %16lu\n", name, frames, blackout / 1000.0,
+           frames ? blackout / frames : 0, animation.overHalfBit, animation.overByte, animation.serialBlackouts);
+  }
+
+  const WS2812Model::Stats &t = strip.total();
+  const sim::Counters &c = sim::counters();
+  printf("\nled frames:      %lu, %.2f ms blackout, longest %lu us\n", t.frames, t.blackoutMicros / 1000.0,
+         t.longestBlackoutMicros);
+  printf("all blackouts:   %lu, %.2f ms, longest %lu us\n", c.blackouts, c.blackoutMicros / 1000.0,
+         c.longestBlackoutMicros);
+  printf("9600 baud limits: half bit %lu us, byte %lu us\n", HALF_BIT_MICROS, BYTE_MICROS);
+  return 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * Checks the serial link counters of the Lawgiver firmware against what the
+ * simulator did to the bytes.
+ *
+ * Runs a build of the sketch with ENABLE_LINK_STATS on the virtual clock,
+ * with a DFPlayer Mini and a VR3 on the serial links, and says --commands
+ * ammo mode words, one every --interval ms with some jitter, while the
+ * trigger is pulled every --fire-every ms. Every --steal-every words the
+ * audio port takes the line with listen() just before the word, the way a
+ * library waiting on a reply from the player would, and EasyVoice has to
+ * notice and take it back.
+ *
+ * Every word the firmware acts on switches the mode, however late: with the
+ * trigger going the voice poll can wait until the shots stop, so the run
+ * ends once the redraws are done and the port is read dry. A word is lost
+ * when its switch never comes.
+ *
+ * The simulator knows the fate of every byte sent to the voice port; the
+ * firmware only sees what a poll can. The run fails when they disagree:
+ *   overflow  every time the port's overflow flag went up is counted once
+ *   deaf      every time the line was taken is counted once
+ *   words     every word that was lost had a byte of its frame dropped,
+ *             missed or corrupted, or left the parser out of step, which is a
+ *             framing or partial error; and if any frame was hit, some error
+ *             was counted
+ * A counter counts what the firmware saw, not bytes, so one overflow can
+ * stand for several words.
+ *
+ * Usage: lawgiver_links [--commands N] [--interval MS] [--fire-every MS]
+ *                       [--steal-every N] [--press MS] [--seed N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "config.h"
+#include "easylinkstats.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern volatile uint8_t selectedAmmoMode;
+extern volatile uint8_t screenUpdates;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long long TAIL = 3000 * MS;  // quiet at the end, so the last flags are polled
+const unsigned long long DRAIN_LIMIT = 120000 * MS;
+const uint8_t MODE_CNT = 7;
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--commands N] [--interval MS] [--fire-every MS] [--steal-every N] [--press MS] [--seed N]\n",
+          name);
+}
+
+/** Bytes that never made it into the buffer. */
+unsigned long gone(const SoftwareSerial::RxStats &rx) {
+  return rx.missed + rx.dropped;
+}
+
+/**
+ * The words said, what happened to their frames on the way in, and which of
+ * them the firmware acted on.
+ *
+ * The firmware reads the frames in order and only a switch of the mode shows
+ * that it acted on one, so each word is given a mode that neither the
+ * firmware nor any word still waiting has: a switch then names the one word
+ * it came from, and the words waiting before that one were skipped.
+ */
+class Words {
+public:
+  explicit Words(SoftwareSerial *port) : _port(port), _mode(selectedAmmoMode), _said(selectedAmmoMode) {}
+
+  void say(VR3Model &vr) {
+    uint8_t mode = nextMode();
+    size_t i = _frames.size();
+    Frame frame = {mode, _port->rxStats().received, 0, gone(_port->rxStats()), _port->rxStats().corrupted,
+                   false, false, false, false};
+    _frames.push_back(frame);
+    _said = mode;
+    unsigned long long frameEnd = vr.say(mode);
+    // a byte's fate is settled when it arrives, polled or not
+    sim::schedule(frameEnd + 2 * MS, [this, i]() {
+      Frame &f = _frames[i];
+      f.last = _port->rxStats().received;
+      if (gone(_port->rxStats()) != f.gone) f.broken = true;
+      if (_port->rxStats().corrupted != f.corrupted) f.hit = true;
+    });
+  }
+
+  void runUntil(unsigned long long until) {
+    while (sim::elapsedMicros() < until) {
+      // a deaf port takes nothing in, so these are the last bytes before listen() flushes
+      unsigned long received = _port->rxStats().received;
+      unsigned long flushed = _port->rxStats().flushed;
+      loop();
+      if (_port->rxStats().flushed != flushed) hitFlushed(received - (_port->rxStats().flushed - flushed), received);
+      if (selectedAmmoMode != _mode) {
+        _mode = selectedAmmoMode;
+        switched(_mode);
+      }
+    }
+  }
+
+  size_t count() const { return _frames.size(); }
+  bool acted(size_t i) const { return _frames[i].acted; }
+  /** A byte of the frame went missing, the firmware can't have acted on it. */
+  bool broken(size_t i) const { return _frames[i].broken; }
+  /** Broken, or a byte of it came in changed. */
+  bool hit(size_t i) const { return _frames[i].broken || _frames[i].hit; }
+
+private:
+  struct Frame {
+    uint8_t mode;
+    unsigned long first, last;     // received count before and after it came in
+    unsigned long gone, corrupted; // the port's counts before it came in
+    bool broken, hit;
+    bool acted, skipped;           // skipped: a later word was acted on first
+  };
+  SoftwareSerial *_port;
+  uint8_t _mode;
+  uint8_t _said;
+  std::vector<Frame> _frames;
+
+  bool waiting(const Frame &f) const { return !f.broken && !f.acted && !f.skipped; }
+
+  uint8_t nextMode() const {
+    for (uint8_t step = 1; step < MODE_CNT; step++) {
+      uint8_t mode = (_said + step) % MODE_CNT;
+      bool taken = mode == _mode;
+      for (const Frame &f : _frames) taken |= waiting(f) && f.mode == mode;
+      if (!taken) return mode;
+    }
+    // more words waiting than there are modes
+    return (_said + 1) % MODE_CNT;
+  }
+
+  /** A corrupted frame can switch to a mode nobody is waiting on, that is left out. */
+  void switched(uint8_t mode) {
+    for (size_t i = 0; i < _frames.size(); i++) {
+      if (!waiting(_frames[i]) || _frames[i].mode != mode) continue;
+      for (size_t j = 0; j < i; j++) {
+        if (waiting(_frames[j])) _frames[j].skipped = true;
+      }
+      _frames[i].acted = true;
+      return;
+    }
+  }
+
+  void hitFlushed(unsigned long first, unsigned long last) {
+    for (size_t i = 0; i < _frames.size(); i++) {
+      if (_frames[i].first < last && _frames[i].last > first) _frames[i].broken = true;
+    }
+  }
+};
+
+bool check(const char *what, bool ok) {
+  if (!ok) fprintf(stderr, "link counters disagree with the simulator: %s\n", what);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long commands = 50;
+  unsigned long interval = 3000;
+  unsigned long fireEvery = 700;
+  unsigned long stealEvery = 10;
+  unsigned long pressTime = 250;
+  unsigned long seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--commands") && i + 1 < argc) {
+      commands = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--interval") && i + 1 < argc) {
+      interval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--fire-every") && i + 1 < argc) {
+      fireEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--steal-every") && i + 1 < argc) {
+      stealEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+      seed = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (interval < 1000 || (fireEvery && fireEvery <= pressTime)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  SoftwareSerial *voicePort = SoftwareSerial::onPin(VOICE_RX_PIN);
+  SoftwareSerial *audioPort = SoftwareSerial::onPin(AUDIO_RX_PIN);
+  // only the main loop counts
+  linkStats().reset();
+  const SoftwareSerial::RxStats before = voicePort->rxStats();
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned long> jitter(0, interval / 2);
+  unsigned long long start = sim::elapsedMicros();
+  unsigned long long end = start + commands * interval * MS;
+  if (fireEvery) {
+    for (unsigned long long t = start + fireEvery * MS; t < end; t += fireEvery * MS) {
+      sim::schedule(t, [pressTime]() {
+        sim::setInput(TRIGGER_PIN, LOW);
+        sim::scheduleAfter(pressTime * MS, []() { sim::setInput(TRIGGER_PIN, -1); });
+      });
+    }
+  }
+
+  Words words(voicePort);
+  unsigned long steals = 0;
+  for (unsigned long i = 0; i < commands; i++) {
+    unsigned long long slot = start + i * interval * MS;
+    words.runUntil(slot + jitter(rng) * MS);
+
+    // two in a row make one deaf spell
+    if (stealEvery && (i + 1) % stealEvery == 0 && voicePort->isListening()) {
+      audioPort->listen();
+      steals++;
+    }
+    words.say(vr);
+    words.runUntil(slot + interval * MS);
+  }
+  // every shot queued a redraw, and the voice poll waits for all of them
+  unsigned long long drainEnd = sim::elapsedMicros() + DRAIN_LIMIT;
+  while ((screenUpdates || voicePort->available()) && sim::elapsedMicros() < drainEnd)
+    words.runUntil(sim::elapsedMicros() + MS);
+  words.runUntil(sim::elapsedMicros() + TAIL);
+
+  unsigned long recognized = 0, hit = 0, hitLost = 0;
+  for (unsigned long i = 0; i < commands; i++) {
+    if (words.acted(i)) recognized++;
+    if (words.hit(i)) hit++;
+    if (words.hit(i) && !words.acted(i)) hitLost++;
+  }
+
+  const SoftwareSerial::RxStats &rx = voicePort->rxStats();
+  unsigned long sent = vr.stats().bytes;
+  unsigned long overflows = rx.overflows - before.overflows;
+  unsigned long lost = commands - recognized;
+  unsigned long fwOverflow = linkStats().total(LINK_VOICE, LINK_OVERFLOW);
+  unsigned long fwDeaf = linkStats().total(LINK_VOICE, LINK_DEAF);
+  unsigned long fwFraming = linkStats().total(LINK_VOICE, LINK_FRAMING);
+  unsigned long fwPartial = linkStats().total(LINK_VOICE, LINK_PARTIAL);
+
+  printf("voice link         simulator                          firmware\n");
+  printf("overflow           %4lu bytes, flag up %lu times         %lu\n", rx.overflowed - before.overflowed, overflows,
+         fwOverflow);
+  printf("deaf               %4lu bytes, line taken %lu times      %lu\n", rx.deaf - before.deaf, steals, fwDeaf);
+  printf("taking it back     %4lu bytes unread and flushed\n", rx.flushed - before.flushed);
+  printf("start bit late     %4lu corrupted, %lu missed             %lu framing, %lu partial\n",
+         rx.corrupted - before.corrupted, rx.missed - before.missed, fwFraming, fwPartial);
+  printf("bytes              %4lu sent, %lu received\n", sent, rx.received - before.received);
+  printf("words              %4lu said, %lu recognized, %lu lost, %lu frames hit, %lu of them lost\n", commands,
+         recognized, lost, hit, hitLost);
+
+  bool ok = check("overflow", fwOverflow == overflows);
+  ok &= check("deaf", fwDeaf == steals);
+  ok &= check("words lost with their frame intact", lost - hitLost <= fwFraming + fwPartial);
+  ok &= check("frames hit but nothing counted", !hit || fwOverflow + fwDeaf + fwFraming + fwPartial > 0);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/**
+ * OLED bus cost runner for the Lawgiver firmware.
+ *
+ * Puts the SH1122 model on the display pins and walks the firmware through
+ * the screens it draws: the start up sequence (trigger held so the DNA check
+ * passes), a few shots and a reload on the main screen. Every frame the
+ * model decodes, whole or just the rows that changed, is listed with the screen it belongs to and what it cost on
+ * the bus: command and data bytes, clock edges, CS transfers and the time
+ * it took to clock out.
+ *
+ * --pgm DIR writes every decoded frame to DIR as a 256x64 grayscale PGM, the
+ * way it looks on the prop, so a screen can be checked by eye.
+ *
+ * Usage: lawgiver_oled [--shots N] [--shot-interval MS] [--pgm DIR]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+
+#include <Arduino.h>
+#include "config.h"
+#include "easyoled.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "sh1122_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN> oled;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long PRESS_TIME = 250;
+
+const char *screenName(int mode) {
+  switch (mode) {
+    case 1: return "logo";
+    case 2: return "comm check";
+    case 3: return "dna check";
+    case 4: return "dna progress";
+    case 5: return "id ok";
+    case 6: return "id name";
+    case 7: return "main";
+    case 8: return "id fail";
+    case 9: return "boot error";
+    default: return "none";
+  }
+}
+
+struct ScreenTotal {
+  unsigned long frames = 0;
+  unsigned long long bytes = 0;
+  unsigned long long clocks = 0;
+  unsigned long long micros = 0;
+};
+
+/** Prints a line per frame and adds it up per screen. */
+class FramePrinter : public SH1122Model::FrameListener {
+public:
+  const char *pgmDir = 0;
+  std::map<int, ScreenTotal> screens;
+
+  void frameDone(const SH1122Model &model, const SH1122Model::Stats &frame) {
+    int mode = oled.getDisplayMode();
+    printf("%5lu  %-12s  %9lu  %10lu  %8lu  %9lu  %8.2f\n", model.frames(), screenName(mode), frame.commandBytes,
+           frame.dataBytes, frame.clocks, frame.transfers, frame.micros() / 1000.0);
+    ScreenTotal &s = screens[mode];
+    s.frames++;
+    s.bytes += frame.bytes();
+    s.clocks += frame.clocks;
+    s.micros += frame.micros();
+    if (pgmDir) {
+      char path[512];
+      snprintf(path, sizeof(path), "%s/frame_%03lu_%d.pgm", pgmDir, model.frames(), mode);
+      // the panel sits upside down in the prop
+      if (!model.writePgm(path, true)) fprintf(stderr, "can't write %s\n", path);
+    }
+  }
+};
+
+/** One pass of the loop. A frame that only sent some rows is done when the pass is. */
+void step(SH1122Model &model) {
+  loop();
+  model.endFrame();
+}
+
+/** Hold a button for PRESS_TIME, then let the firmware run for wait ms. */
+void press(SH1122Model &model, uint8_t pin, unsigned long wait) {
+  sim::setInput(pin, LOW);
+  sim::scheduleAfter(PRESS_TIME * MS, [pin]() { sim::setInput(pin, -1); });
+  unsigned long long end = sim::elapsedMicros() + wait * MS;
+  while (sim::elapsedMicros() < end) step(model);
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS] [--pgm DIR]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 3;
+  unsigned long shotInterval = 2000;
+  FramePrinter printer;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--pgm") && i + 1 < argc) {
+      printer.pgmDir = argv[++i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (shotInterval <= PRESS_TIME) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  SH1122Model model(OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN);
+  model.attach();
+  model.setFrameListener(&printer);
+
+  printf("frame  screen        cmd bytes  data bytes    clocks  transfers        ms\n");
+  setup();
+  model.endFrame();
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) step(model);
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  for (unsigned long i = 0; i < shots; i++) press(model, TRIGGER_PIN, shotInterval);
+  press(model, RELOAD_PIN, shotInterval);
+
+  printf("\nscreen        frames  bytes/frame  clocks/frame  ms/frame\n");
+  for (std::map<int, ScreenTotal>::const_iterator it = printer.screens.begin(); it != printer.screens.end(); ++it) {
+    const ScreenTotal &s = it->second;
+    printf("%-12s  %6lu  %11llu  %12llu  %8.2f\n", screenName(it->first), s.frames, s.bytes / s.frames,
+           s.clocks / s.frames, s.micros / 1000.0 / s.frames);
+  }
+  const SH1122Model::Stats &t = model.total();
+  printf("bus total:    %lu command + %lu data bytes, %lu clocks, %lu transfers\n", t.commandBytes, t.dataBytes,
+         t.clocks, t.transfers);
+  if (model.unknownCommands()) printf("unknown commands: %lu\n", model.unknownCommands());
+  return model.frames() ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/**
+ * Transport and buffer policy benchmark for EasyOLED on the SH1122.
+ *
+ * Builds EasyOLED with every transport and page buffer in easyoledpolicy.h,
+ * on the ENABLE_OLED_HW_SPI pin map, and for each pair reports the page
+ * buffer RAM, the time the logo takes to draw after begin(), and
+ * the time a shot takes to repaint the main screen. The SPI transports also
+ * go through the SH1122 model, and what ends up on the glass has to match
+ * the bit-banged two page build, which is what the prop runs; a pair that
+ * differs fails the run. Nothing decodes the I2C bus, so those are only
+ * timed.
+ *
+ * Times are bus time on the virtual clock: pin toggles for the bit-banged
+ * transports and 8 or 9 clocks a byte for the hardware ports. Flash, and the
+ * RAM of the whole sketch, come from the AVR build, see extras/avr_bench.
+ *
+ * Usage: lawgiver_oled_policies
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "config.h"
+#include "easyoled.h"
+#include "sim.h"
+#include "sh1122_model.h"
+
+namespace {
+
+const uint8_t FULL_COUNTS[4] = {25, 25, 25, 50};
+
+// what the glass showed with the first pair, for the others to match
+uint8_t refLogo[SH1122Model::HEIGHT][SH1122Model::WIDTH];
+uint8_t refShot[SH1122Model::HEIGHT][SH1122Model::WIDTH];
+bool haveRef = false;
+
+/** Keep the glass in ref, or count the pixels that differ from it. */
+long glass(const SH1122Model &model, uint8_t ref[SH1122Model::HEIGHT][SH1122Model::WIDTH], bool keep) {
+  long diff = 0;
+  for (int y = 0; y < SH1122Model::HEIGHT; y++) {
+    for (int x = 0; x < SH1122Model::WIDTH; x++) {
+      if (keep) ref[y][x] = model.pixel(x, y);
+      else if (ref[y][x] != model.pixel(x, y)) diff++;
+    }
+  }
+  return diff;
+}
+
+template<class TRANSPORT, class BUFFER>
+bool run(const char *transport, const char *buffer, bool decoded) {
+  typedef EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN, TRANSPORT, BUFFER> Oled;
+  sim::reset();
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  SH1122Model model(OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN);
+  model.attach();
+
+  Oled *oled = new Oled();
+  uint8_t counts[4];
+  memcpy(counts, FULL_COUNTS, sizeof(counts));
+  oled->begin(VR_CMD_AMMO_MODE_FMJ, counts);
+
+  unsigned long long start = sim::elapsedMicros();
+  oled->updateDisplayMode(Oled::DISPLAY_LOGO, 0);
+  unsigned long long logoUs = sim::elapsedMicros() - start;
+  model.endFrame();
+  long logoDiff = glass(model, refLogo, !haveRef);
+
+  oled->updateDisplayMode(Oled::DISPLAY_MAIN, 0);
+  counts[3]--;
+  start = sim::elapsedMicros();
+  oled->updateDisplay(VR_CMD_AMMO_MODE_FMJ, counts);
+  unsigned long long shotUs = sim::elapsedMicros() - start;
+  model.endFrame();
+  long shotDiff = glass(model, refShot, !haveRef);
+  haveRef = true;
+
+  delete oled;
+  SPI.attach(0);
+
+  const char *result = "-";
+  bool ok = true;
+  if (decoded) {
+    ok = logoDiff == 0 && shotDiff == 0;
+    result = ok ? "same" : "differs";
+  }
+  printf("%-14s %-10s %8u %10.2f %10.2f  %s\n", transport, buffer, 32 * 8 * BUFFER::TILE_ROWS,
+         logoUs / 1000.0, shotUs / 1000.0, result);
+  return ok;
+}
+
+template<class BUFFER>
+int runBuffer(const char *buffer) {
+  int failed = 0;
+  if (!run<OledSwSpi, BUFFER>("OledSwSpi", buffer, true)) failed++;
+  if (!run<OledHwSpi, BUFFER>("OledHwSpi", buffer, true)) failed++;
+  if (!run<OledHwI2c, BUFFER>("OledHwI2c", buffer, false)) failed++;
+  if (!run<OledSwI2c, BUFFER>("OledSwI2c", buffer, false)) failed++;
+  return failed;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    fprintf(stderr, "usage: %s\n", argv[0]);
+    return 2;
+  }
+  printf("%-14s %-10s %8s %10s %10s  %s\n", "transport", "buffer", "buffer B", "logo ms", "shot ms",
+         "glass");
+  // the prop's build first, it's the one the others have to match
+  int failed = runBuffer<OledPage2>("OledPage2");
+  failed += runBuffer<OledPage1>("OledPage1");
+  failed += runBuffer<OledFull>("OledFull");
+  if (failed) printf("%d pairs draw a different screen\n", failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+/**
+ * Power budget of the Lawgiver, per state, from recorded sessions.
+ *
+ * Boots a build of the sketch with ENABLE_DEBUG and ENABLE_PROFILE on the
+ * virtual clock, replays the recordings given on the command line the way
+ * lawgiver_replay does, then leaves the prop alone for --idle seconds. Every
+ * stretch of time is put down to one state:
+ *   startup  the start up sequence, DNA check passed
+ *   theme    the theme track is playing
+ *   firing   up to --firing-hold ms after a trigger press
+ *   idle     anything else
+ * and charged for what each part draws from the 5 V rail over it:
+ *   leds     FastLED's calculate_unscaled_power_mW() on every frame the
+ *            jewel shows, scaled by the brightness applied to it
+ *   oled     from the gray levels lit on the SH1122 and its contrast
+ *   audio    the DFPlayer, more while a track plays
+ *   mcu      the Nano; the sketch never sleeps, so it draws the same all the
+ *            time. The share the loop was busy is the time the profiler saw
+ *            in its stages, less what the simulator spent in delay() or
+ *            skipping idle polls. The rest is waiting and could be asleep.
+ *
+ * The LED figures are FastLED's own. The rest are estimates, see the
+ * constants below, so compare them with the prop on a meter before trusting
+ * the totals. Assuming the pack feeds everything through the linear 5 V
+ * regulator, it supplies the rail's current, which gives the hours a state
+ * lasts on --pack-mah.
+ *
+ * Usage: lawgiver_power [--idle S] [--firing-hold MS] [--pack-mah N]
+ *                       [--theme-ms MS] recording.log ...
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+#include "easyprofiler.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "recording.h"
+#include "dfplayer_model.h"
+#include "sh1122_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern EasyProfiler profiler;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long long LEAD = 1000 * MS;  // after the start up sequence, before the first event
+const unsigned long long TAIL = 2000 * MS;  // after the last event
+
+// Estimates for the 5 V rail, in mW
+const double OLED_BASE_MW = 20;    // SH1122 logic and charge pump, screen black
+const double OLED_FULL_MW = 600;   // every pixel at level 15, contrast 255
+const double OLED_OFF_MW = 5;      // display off
+const double AUDIO_IDLE_MW = 100;  // DFPlayer Mini waiting, about 20 mA
+const double AUDIO_PLAY_MW = 500;  // on top, a track at volume 30 into the speaker
+const double MCU_MW = 100;         // Nano at 16 MHz: ATmega328P, USB chip and power LED
+const double RAIL_V = 5.0;
+
+enum State { STARTUP, IDLE, FIRING, THEME, STATE_CNT };
+const char *STATE_NAMES[STATE_CNT] = {"startup", "idle", "firing", "theme"};
+
+enum Part { LEDS, OLED, AUDIO, MCU, PART_CNT };
+
+struct Account {
+  unsigned long long micros = 0;
+  unsigned long long busyMicros = 0;
+  double mJ[PART_CNT] = {0};
+};
+
+/** Keeps the power each part draws now and charges it to the current state. */
+class Meter : public sim::LedListener, public SH1122Model::FrameListener, public DFPlayerModel::PlaybackListener {
+public:
+  Account accounts[STATE_CNT];
+  State state = STARTUP;
+  double mW[PART_CNT] = {0, OLED_OFF_MW, AUDIO_IDLE_MW, MCU_MW};
+  int track = -1;  // playing, or -1
+
+  /** Charges the time since the last call to the current state. */
+  void account() {
+    unsigned long long now = sim::elapsedMicros();
+    Account &a = accounts[state];
+    a.micros += now - _last;
+    for (int i = 0; i < PART_CNT; i++) a.mJ[i] += mW[i] * (now - _last) / 1e6;
+    _last = now;
+  }
+
+  void busy(unsigned long long us) { accounts[state].busyMicros += us; }
+
+  void frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) {
+    if (pin != FIRE_LED_PIN) return;
+    account();
+    uint32_t unscaled = calculate_unscaled_power_mW((const CRGB *)rgb, count);
+    uint32_t dark = 5 * count;  // FastLED's gDark_mW, not scaled by brightness
+    mW[LEDS] = dark + (unscaled - dark) * (double)brightness / 256;
+  }
+
+  void frameDone(const SH1122Model &model, const SH1122Model::Stats &frame) {
+    account();
+    mW[OLED] = oledPower(model);
+  }
+
+  void trackStarted(int t) {
+    account();
+    track = t;
+    mW[AUDIO] = AUDIO_IDLE_MW + AUDIO_PLAY_MW;
+  }
+
+  void trackStopped(int t, bool finished) {
+    account();
+    track = -1;
+    mW[AUDIO] = AUDIO_IDLE_MW;
+  }
+
+  static double oledPower(const SH1122Model &model) {
+    if (!model.displayOn()) return OLED_OFF_MW;
+    unsigned long lit = 0;
+    for (int y = 0; y < SH1122Model::HEIGHT; y++) {
+      for (int x = 0; x < SH1122Model::WIDTH; x++) lit += model.pixel(x, y);
+    }
+    double full = (double)lit / (15.0 * SH1122Model::WIDTH * SH1122Model::HEIGHT);
+    return OLED_BASE_MW + OLED_FULL_MW * full * model.contrast() / 255;
+  }
+
+private:
+  unsigned long long _last = 0;
+};
+
+/** Time in the profiled stages so far. */
+unsigned long long stageMicros() {
+  unsigned long ticks = 0;
+  for (uint8_t i = 0; i < PROFILE_STAGE_CNT; i++) ticks += profiler.total(i);
+  return ticks / 2;
+}
+
+/** Time the simulator spent waiting so far. */
+unsigned long long waitMicros() {
+  return sim::clockStats().idleMicros + sim::clockStats().delayMicros;
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--idle S] [--firing-hold MS] [--pack-mah N] [--theme-ms MS] recording.log ...\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long idle = 60;
+  unsigned long firingHold = 1000;
+  unsigned long packMah = 800;
+  unsigned long themeMillis = 60000;
+  std::vector<const char *> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--idle") && i + 1 < argc) {
+      idle = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--firing-hold") && i + 1 < argc) {
+      firingHold = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--pack-mah") && i + 1 < argc) {
+      packMah = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--theme-ms") && i + 1 < argc) {
+      themeMillis = strtoul(argv[++i], 0, 10);
+    } else if (argv[i][0] != '-') {
+      paths.push_back(argv[i]);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<std::vector<RecordedInput> > sessions(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (!readRecording(paths[i], sessions[i])) {
+      fprintf(stderr, "can't read %s\n", paths[i]);
+      return 1;
+    }
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  Meter meter;
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  player.setTrackMillis(AUDIO_TRACK_THEME, themeMillis);
+  player.setPlaybackListener(&meter);
+  VR3Model vr(VOICE_RX_PIN);
+  vr.setRecognizeMillis(0);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+  SH1122Model oled(OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN);
+  oled.attach();
+  oled.setFrameListener(&meter);
+  sim::addLedListener(&meter);
+
+  unsigned long long lastPress = 0;
+  bool pressed = false;
+  unsigned long long stages = 0, waited = 0;
+  // one pass of the loop, charged to the state it started in
+  auto step = [&]() {
+    loop();
+    meter.account();
+    unsigned long long s = stageMicros(), w = waitMicros();
+    // the profiler halves its totals now and then, skip that pass
+    if (s >= stages && s - stages > w - waited) meter.busy(s - stages - (w - waited));
+    stages = s;
+    waited = w;
+    unsigned long long now = sim::elapsedMicros();
+    if (loopStage == LOOP_STATE_START) meter.state = STARTUP;
+    else if (meter.track == AUDIO_TRACK_THEME) meter.state = THEME;
+    else if (pressed && now < lastPress + firingHold * MS) meter.state = FIRING;
+    else meter.state = IDLE;
+  };
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  setup();
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) step();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  for (size_t s = 0; s < sessions.size(); s++) {
+    const std::vector<RecordedInput> &inputs = sessions[s];
+    if (inputs.empty()) continue;
+    unsigned long long start = sim::elapsedMicros() + LEAD;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const RecordedInput &e = inputs[i];
+      unsigned long long at = start + e.at;
+      if (e.id == TRACE_VOICE_COMMAND) {
+        vr.sayAt(at - 10 * MS, e.arg);
+      } else {
+        uint8_t pin = e.arg;
+        bool down = e.id == TRACE_BUTTON_DOWN;
+        sim::schedule(at, [pin, down, &lastPress, &pressed]() {
+          sim::setInput(pin, down ? LOW : -1);
+          if (down && pin == TRIGGER_PIN) {
+            lastPress = sim::elapsedMicros();
+            pressed = true;
+          }
+        });
+      }
+    }
+    unsigned long long end = start + inputs.back().at + TAIL;
+    while (sim::elapsedMicros() < end) step();
+  }
+  unsigned long long end = sim::elapsedMicros() + idle * 1000 * MS;
+  while (sim::elapsedMicros() < end) step();
+  fflush(stdout);
+
+  printf("\nstate     time s busy %%  leds mW  oled mW audio mW   mcu mW total mW  mA@5V  hours\n");
+  Account all;
+  for (int s = 0; s < STATE_CNT; s++) {
+    const Account &a = meter.accounts[s];
+    all.micros += a.micros;
+    all.busyMicros += a.busyMicros;
+    for (int i = 0; i < PART_CNT; i++) all.mJ[i] += a.mJ[i];
+  }
+  for (int s = 0; s <= STATE_CNT; s++) {
+    const Account &a = s < STATE_CNT ? meter.accounts[s] : all;
+    printf("%-8s %7.1f", s < STATE_CNT ? STATE_NAMES[s] : "all", a.micros / 1e6);
+    if (!a.micros) {
+      printf("\n");
+      continue;
+    }
+    double seconds = a.micros / 1e6;
+    double total = 0;
+    printf(" %6.1f", 100.0 * a.busyMicros / a.micros);
+    for (int i = 0; i < PART_CNT; i++) {
+      printf(" %8.1f", a.mJ[i] / seconds);
+      total += a.mJ[i] / seconds;
+    }
+    double mA = total / RAIL_V;
+    printf(" %8.1f %6.1f %6.1f\n", total, mA, packMah / mA);
+  }
+  return 0;
+}
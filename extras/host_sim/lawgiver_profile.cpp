@@ -0,0 +1,143 @@
+/**
+ * Loop profile of the Lawgiver firmware.
+ *
+ * Runs a build of the sketch with ENABLE_DEBUG, ENABLE_PROFILE and
+ * ENABLE_LINK_STATS on the virtual clock, with a DFPlayer Mini and a VR3 on the serial links. After the
+ * start up sequence it pulls the trigger --shots times, one every
+ * --shot-interval ms, says an ammo mode word every --word-every shots and
+ * presses reload after every --reload-every shots. Then it types 'p' and 'l'
+ * into the debug port, the same commands that work from a serial monitor on
+ * the prop, and the firmware prints its stage table and its serial link
+ * counters after its debug output. Below them goes what the simulator did to
+ * the bytes sent to each port over the same run, for the counters to be
+ * read against:
+ *
+ *   lawgiver_profile --shots 50 | tail -17
+ *
+ * The simulator only charges time for what the firmware does on its pins and
+ * serial ports, not for the CPU, so the table shows where the loop waits.
+ *
+ * Usage: lawgiver_profile [--shots N] [--shot-interval MS] [--press MS]
+ *                         [--word-every N] [--reload-every N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern volatile uint8_t selectedAmmoMode;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const uint8_t MODE_CNT = 7;
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS] [--press MS] [--word-every N] [--reload-every N]\n", name);
+}
+
+void press(uint8_t pin, unsigned long pressTime) {
+  sim::setInput(pin, LOW);
+  sim::scheduleAfter(pressTime * MS, [pin]() { sim::setInput(pin, -1); });
+}
+
+void runFor(unsigned long long us) {
+  unsigned long long end = sim::elapsedMicros() + us;
+  while (sim::elapsedMicros() < end) loop();
+}
+
+void printRx(const char *name, const SoftwareSerial::RxStats &now, const SoftwareSerial::RxStats &before) {
+  printf("%s\t%lu\t%lu\t%lu\t%lu\t%lu\n", name, now.received - before.received, now.corrupted - before.corrupted,
+         now.missed - before.missed, now.deaf - before.deaf, now.overflowed - before.overflowed);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 20;
+  unsigned long shotInterval = 1000;
+  unsigned long pressTime = 250;
+  unsigned long wordEvery = 4;
+  unsigned long reloadEvery = 5;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--word-every") && i + 1 < argc) {
+      wordEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--reload-every") && i + 1 < argc) {
+      reloadEvery = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  // only the main loop counts
+  Serial.receive('r');
+  Serial.receive('c');
+  SoftwareSerial *voicePort = SoftwareSerial::onPin(VOICE_RX_PIN);
+  SoftwareSerial *audioPort = SoftwareSerial::onPin(AUDIO_RX_PIN);
+  const SoftwareSerial::RxStats voiceBefore = voicePort->rxStats();
+  const SoftwareSerial::RxStats audioBefore = audioPort->rxStats();
+
+  for (unsigned long i = 0; i < shots; i++) {
+    press(TRIGGER_PIN, pressTime);
+    if (wordEvery && (i + 1) % wordEvery == 0) {
+      // say it halfway to the next shot
+      vr.sayAt(sim::elapsedMicros() + shotInterval * MS / 2, (selectedAmmoMode + 1) % MODE_CNT);
+    }
+    runFor(shotInterval * MS);
+    if (reloadEvery && (i + 1) % reloadEvery == 0) {
+      press(RELOAD_PIN, pressTime);
+      runFor(shotInterval * MS);
+    }
+  }
+  // the next pass through the main loop answers
+  Serial.receive('p');
+  Serial.receive('l');
+  loop();
+  fflush(stdout);
+  printf("port\tbytes\tlate\tmissed\tdeaf\tfull\n");
+  printRx("voice", voicePort->rxStats(), voiceBefore);
+  printRx("audio", audioPort->rxStats(), audioBefore);
+  return 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * Replays a recorded play session through the Lawgiver firmware.
+ *
+ * A recording is the debug log of a firmware built with ENABLE_DEBUG and
+ * ENABLE_RECORD (or ENABLE_TRACE), captured from the prop's serial monitor.
+ * Only its input lines are used (see the TRACE Macros in config.h):
+ *   ~I7 <micros> <pin>      EasyButton saw the button on pin go down
+ *   ~I8 <micros> <pin>      and come back up
+ *   ~I9 <micros> <record>   checkVoiceCommands() got a voice command
+ * Everything else in the log is skipped.
+ *
+ * After the start up sequence the events are played back at their recorded
+ * spacing: the pins change --debounce ms before the recorded edge, so they
+ * come out of ezButton and EasyButton::checkState() on time, and a VR3 model
+ * sends each voice command's recognition frame so it has arrived by then.
+ *
+ * For every event the runner looks for the first LED frame and the first
+ * audio command the firmware sent in answer, up to the next event. Latency
+ * is measured from the recorded time. A trigger press has to show an LED
+ * frame within --led-budget ms and send the audio command within
+ * --audio-budget ms. A press that gets neither (an empty clip still plays a
+ * sound) went unseen, which happens to short presses while the loop is busy
+ * redrawing the screen. The run fails when a press misses either budget, or
+ * when more than --max-missed presses went unseen.
+ *
+ * Usage: lawgiver_replay [--debounce MS] [--led-budget MS] [--audio-budget MS]
+ *                        [--max-missed N] [--log] recording.log
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "recording.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long long LEAD = 1000 * MS;      // settle after the start up sequence
+const unsigned long long TAIL = 2000 * MS;      // run on after the last event
+const unsigned long long NONE = ~0ULL;
+
+struct Event : RecordedInput {
+  unsigned long long led = NONE;    // first LED frame after it
+  unsigned long long audio = NONE;  // first audio command after it
+};
+
+struct Latency {
+  unsigned long count = 0;
+  unsigned long long total = 0;
+  unsigned long long min = NONE;
+  unsigned long long max = 0;
+
+  void add(unsigned long long us) {
+    count++;
+    total += us;
+    if (us < min) min = us;
+    if (us > max) max = us;
+  }
+};
+
+/** Collects the replayed events and stamps the firmware's answers onto the latest one. */
+class Replay : public sim::LedListener, public sim::SerialDevice {
+public:
+  DFPlayerMiniModel *player = 0;
+  std::vector<Event> events;
+  unsigned long long start = 0;
+  int current = -1;  // the latest event that is due
+
+  void frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) {
+    if (pin != FIRE_LED_PIN) return;
+    Event *e = due();
+    if (e && e->led == NONE) e->led = sim::elapsedMicros();
+  }
+
+  void receive(uint8_t b) {
+    // the start byte of a packet
+    Event *e = b == 0x7E ? due() : 0;
+    if (e && e->audio == NONE) e->audio = sim::elapsedMicros();
+    player->receive(b);
+  }
+
+private:
+  Event *due() {
+    unsigned long long now = sim::elapsedMicros();
+    if (!start) return 0;  // still booting
+    while (current + 1 < (int)events.size() && start + events[current + 1].at <= now) current++;
+    return current >= 0 ? &events[current] : 0;
+  }
+};
+
+const char *eventName(const Event &e) {
+  if (e.id == TRACE_VOICE_COMMAND) return "voice";
+  bool down = e.id == TRACE_BUTTON_DOWN;
+  if (e.arg == TRIGGER_PIN) return down ? "trigger down" : "trigger up";
+  if (e.arg == RELOAD_PIN) return down ? "reload down" : "reload up";
+  return down ? "button down" : "button up";
+}
+
+void printLatency(const char *name, const Latency &l) {
+  if (!l.count) {
+    printf("  %-6s none\n", name);
+    return;
+  }
+  printf("  %-6s %4lu  min %6.1f ms  avg %6.1f ms  max %6.1f ms\n", name, l.count, l.min / 1000.0,
+         l.total / 1000.0 / l.count, l.max / 1000.0);
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--debounce MS] [--led-budget MS] [--audio-budget MS] [--max-missed N] [--log] recording.log\n",
+          name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long debounce = 25;
+  unsigned long ledBudget = 5;
+  unsigned long audioBudget = 15;
+  unsigned long maxMissed = 0;
+  bool log = false;
+  const char *path = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--debounce") && i + 1 < argc) {
+      debounce = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--led-budget") && i + 1 < argc) {
+      ledBudget = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--audio-budget") && i + 1 < argc) {
+      audioBudget = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--max-missed") && i + 1 < argc) {
+      maxMissed = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--log")) {
+      log = true;
+    } else if (argv[i][0] != '-' && !path) {
+      path = argv[i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (!path) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  Replay replay;
+  std::vector<RecordedInput> inputs;
+  if (!readRecording(path, inputs)) {
+    fprintf(stderr, "can't read %s\n", path);
+    return 1;
+  }
+  for (size_t i = 0; i < inputs.size(); i++) {
+    Event e;
+    static_cast<RecordedInput &>(e) = inputs[i];
+    replay.events.push_back(e);
+  }
+  if (replay.events.empty()) {
+    fprintf(stderr, "no input events in %s, was it recorded with ENABLE_RECORD?\n", path);
+    return 1;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  vr.setRecognizeMillis(0);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+  // sit between the sketch and the player to see its commands first
+  replay.player = &player;
+  SoftwareSerial::onPin(AUDIO_RX_PIN)->attach(&replay);
+  sim::addLedListener(&replay);
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  // on a millis() tick, ezButton times the debounce in whole ms and would see
+  // a press that starts part way through one up to a ms before its recorded time
+  replay.start = (sim::elapsedMicros() + LEAD) / MS * MS;
+  for (size_t i = 0; i < replay.events.size(); i++) {
+    const Event &e = replay.events[i];
+    unsigned long long at = replay.start + e.at;
+    if (e.id == TRACE_VOICE_COMMAND) {
+      // the frame is 9 bytes, about 10 ms at 9600 baud
+      vr.sayAt(at - 10 * MS, e.arg);
+    } else {
+      uint8_t pin = e.arg;
+      int level = e.id == TRACE_BUTTON_DOWN ? LOW : -1;
+      sim::schedule(at - debounce * MS, [pin, level]() { sim::setInput(pin, level); });
+    }
+  }
+  unsigned long long end = replay.start + replay.events.back().at + TAIL;
+  while (sim::elapsedMicros() < end) loop();
+
+  Latency triggerLed, triggerAudio, otherAudio;
+  unsigned long presses = 0, missed = 0, over = 0;
+  for (size_t i = 0; i < replay.events.size(); i++) {
+    const Event &e = replay.events[i];
+    unsigned long long seen = replay.start + e.at;
+    bool trigger = e.id == TRACE_BUTTON_DOWN && e.arg == TRIGGER_PIN;
+    bool ledOver = false, audioOver = false;
+    if (trigger) {
+      presses++;
+      if (e.led != NONE) {
+        triggerLed.add(e.led - seen);
+        ledOver = e.led - seen > ledBudget * MS;
+      }
+      if (e.audio != NONE) {
+        triggerAudio.add(e.audio - seen);
+        audioOver = e.audio - seen > audioBudget * MS;
+      }
+      if (e.led == NONE && e.audio == NONE) missed++;
+      if (ledOver || audioOver) over++;
+    } else if (e.audio != NONE) {
+      otherAudio.add(e.audio - seen);
+    }
+    if (log) {
+      printf("%10.1f ms  %-12s", e.at / 1000.0, eventName(e));
+      if (e.led != NONE) printf("  led %6.1f ms%s", (e.led - seen) / 1000.0, ledOver ? " (over)" : "");
+      if (e.audio != NONE) printf("  audio %6.1f ms%s", (e.audio - seen) / 1000.0, audioOver ? " (over)" : "");
+      printf("\n");
+    }
+  }
+
+  printf("recording:       %s, %lu events over %.1f s\n", path, (unsigned long)replay.events.size(),
+         replay.events.back().at / 1e6);
+  printf("trigger presses: %lu, %lu unseen, %lu over budget (led %lu ms, audio %lu ms)\n", presses, missed, over,
+         ledBudget, audioBudget);
+  printLatency("led", triggerLed);
+  printLatency("audio", triggerAudio);
+  printf("other events:    audio answer\n");
+  printLatency("audio", otherAudio);
+  return missed > maxMissed || over ? 1 : 0;
+}
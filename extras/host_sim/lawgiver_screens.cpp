@@ -0,0 +1,188 @@
+/**
+ * Golden image check for the Lawgiver OLED screens.
+ *
+ * Draws every screen EasyOLED knows through the firmware's own display object
+ * and decodes it with the SH1122 model: the start up screens at a few
+ * progress steps and both blink phases, the boot error, and the main screen
+ * for every ammo selection full, low and empty. Each frame is compared with
+ * a committed PGM of the same name in --golden DIR, the way it looks on the
+ * prop. A screen that differs, or has no golden image yet, fails the run.
+ *
+ * Every screen also lists what it cost: the time drawDisplay() took from the
+ * first page to the last flush, and the bytes and clocks on the bus. The main
+ * screens are drawn the way a shot draws them, from one round more, so their
+ * cost is only the rows that changed.
+ *
+ * --out DIR writes the frames that were drawn, to look at a failure.
+ * --update writes them over the golden images instead of comparing, for a
+ * change that is meant to look different.
+ *
+ * Usage: lawgiver_screens [--golden DIR] [--out DIR] [--update]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include "config.h"
+#include "easyoled.h"
+#include "sim.h"
+#include "sh1122_model.h"
+
+typedef EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN> Oled;
+extern Oled oled;
+
+namespace {
+
+const uint8_t FULL_COUNTS[4] = {25, 25, 25, 50};
+const uint8_t LOW_COUNT = 3;
+// ammo counter used by each ammo mode, see EasyOLED::_ammoIdx
+const uint8_t AMMO_IDX[7] = {0, 1, 1, 2, 3, 3, 3};
+const char *AMMO_NAMES[7] = {"ap", "in", "hs", "he", "st", "fmj", "rapid"};
+
+struct Screen {
+  std::string name;
+  std::function<void()> prepare;  // untimed, may draw frames of its own
+  std::function<void()> draw;     // the frame that is checked
+};
+
+void startUpScreen(std::vector<Screen> &screens, const char *name, int mode, uint8_t progress, bool blink = false) {
+  screens.push_back(Screen{name, []() {}, [mode, progress, blink]() { oled.updateDisplayMode(mode, progress, blink); }});
+}
+
+/** The main screen for an ammo mode, with its counter at count (or all full). */
+void mainScreen(std::vector<Screen> &screens, int ammoMode, const char *state, int count) {
+  std::string name = std::string("main_") + AMMO_NAMES[ammoMode] + "_" + state;
+  uint8_t counts[4];
+  memcpy(counts, FULL_COUNTS, sizeof(counts));
+  if (count >= 0) counts[AMMO_IDX[ammoMode]] = count;
+  uint8_t before[4];
+  memcpy(before, counts, sizeof(before));
+  before[AMMO_IDX[ammoMode]]++;
+  // the firmware checks the levels after a shot, then redraws
+  screens.push_back(Screen{name,
+                           [ammoMode, before]() mutable {
+                             oled.updateDisplay(ammoMode, before);
+                             oled.checkAmmoLevels();
+                             oled.updateDisplay(ammoMode, before);
+                           },
+                           [ammoMode, counts]() mutable { oled.updateDisplay(ammoMode, counts); }});
+}
+
+std::vector<Screen> allScreens() {
+  std::vector<Screen> screens;
+  startUpScreen(screens, "logo", Oled::DISPLAY_LOGO, 0);
+  startUpScreen(screens, "comm_chk_0", Oled::DISPLAY_COMM_CHK, 0);
+  startUpScreen(screens, "comm_chk_5", Oled::DISPLAY_COMM_CHK, 5);
+  startUpScreen(screens, "comm_chk_9", Oled::DISPLAY_COMM_CHK, 9);
+  startUpScreen(screens, "dna_chk", Oled::DISPLAY_DNA_CHK, 0);
+  startUpScreen(screens, "dna_prg_5", Oled::DISPLAY_DNA_PRG, 5);
+  startUpScreen(screens, "dna_prg_9", Oled::DISPLAY_DNA_PRG, 9);
+  startUpScreen(screens, "id_ok_on", Oled::DISPLAY_ID_OK, 9, true);
+  startUpScreen(screens, "id_ok_off", Oled::DISPLAY_ID_OK, 9, false);
+  startUpScreen(screens, "id_name", Oled::DISPLAY_ID_NAME, 9);
+  startUpScreen(screens, "id_fail_on", Oled::DISPLAY_ID_FAIL, 9, true);
+  startUpScreen(screens, "id_fail_off", Oled::DISPLAY_ID_FAIL, 9, false);
+  startUpScreen(screens, "boot_error", Oled::DISPLAY_BOOT_ERROR, 0);
+  // switch to the main screen, progress isn't drawn there
+  screens.push_back(Screen{"", []() {}, []() { oled.updateDisplayMode(Oled::DISPLAY_MAIN, 0); }});
+  for (int mode = 0; mode < 7; mode++) {
+    mainScreen(screens, mode, "full", -1);
+    mainScreen(screens, mode, "low", LOW_COUNT);
+    mainScreen(screens, mode, "empty", 0);
+  }
+  return screens;
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--golden DIR] [--out DIR] [--update]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *goldenDir = 0;
+  const char *outDir = 0;
+  bool update = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--golden") && i + 1 < argc) {
+      goldenDir = argv[++i];
+    } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (!strcmp(argv[i], "--update")) {
+      update = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (update && !goldenDir) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  SH1122Model model(OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN);
+  model.attach();
+  uint8_t counts[4];
+  memcpy(counts, FULL_COUNTS, sizeof(counts));
+  oled.begin(VR_CMD_AMMO_MODE_FMJ, counts);
+
+  int failed = 0;
+  printf("%-20s  %9s  %9s  %8s  %s\n", "screen", "draw ms", "bus bytes", "clocks", goldenDir && !update ? "golden" : "");
+  std::vector<Screen> screens = allScreens();
+  for (size_t i = 0; i < screens.size(); i++) {
+    const Screen &screen = screens[i];
+    screen.prepare();
+    model.endFrame();
+    unsigned long frames = model.frames();
+    unsigned long long start = sim::elapsedMicros();
+    screen.draw();
+    unsigned long long drawUs = sim::elapsedMicros() - start;
+    model.endFrame();
+    if (screen.name.empty()) continue;
+    if (model.frames() == frames) {
+      printf("%-20s  no frame was sent\n", screen.name.c_str());
+      failed++;
+      continue;
+    }
+
+    const SH1122Model::Stats &frame = model.lastFrame();
+    char path[512];
+    std::string result;
+    // the panel sits upside down in the prop
+    if (outDir) {
+      snprintf(path, sizeof(path), "%s/%s.pgm", outDir, screen.name.c_str());
+      if (!model.writePgm(path, true)) fprintf(stderr, "can't write %s\n", path);
+    }
+    if (goldenDir) {
+      snprintf(path, sizeof(path), "%s/%s.pgm", goldenDir, screen.name.c_str());
+      if (update) {
+        if (!model.writePgm(path, true)) {
+          fprintf(stderr, "can't write %s\n", path);
+          failed++;
+        }
+      } else {
+        long diff = model.comparePgm(path, true);
+        if (diff < 0) {
+          result = "missing";
+          failed++;
+        } else if (diff > 0) {
+          result = std::to_string(diff) + " pixels differ";
+          failed++;
+        } else {
+          result = "ok";
+        }
+      }
+    }
+    printf("%-20s  %9.2f  %9lu  %8lu  %s\n", screen.name.c_str(), drawUs / 1000.0, frame.bytes(), frame.clocks,
+           result.c_str());
+  }
+
+  if (failed) printf("%d screens failed\n", failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * Soak runner for the Lawgiver firmware.
+ *
+ * Replays a convention day of trigger pulls on the virtual clock: the prop
+ * boots, passes the DNA check and then gets pulled every --shot-interval ms
+ * for --hours, with a reload every --reload-every pulls. Idle stretches are
+ * skipped by jumping to the next firmware deadline, so a full day runs in
+ * seconds.
+ *
+ * Every pull must be answered with LED frames or an audio command within a
+ * second, and every shot must reach the display within two. Anything that
+ * goes quiet (eg. a timer that never fires again after millis() wraps) shows
+ * up as missed pulls in the hourly report and fails the run.
+ *
+ * --wrap-after starts millis() close to 0xFFFFFFFF so the 49 day rollover
+ * lands that many milliseconds after power on.
+ *
+ * Usage: lawgiver_soak [--hours H] [--shot-interval MS] [--press MS]
+ *                      [--reload-every N] [--wrap-after MS] [--step US]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long HOUR = 3600ULL * 1000ULL * MS;
+const unsigned long long ANSWER_WINDOW = 1000 * MS;
+const unsigned long long DISPLAY_WINDOW = 2000 * MS;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+
+/** Counts what the firmware sends out, the signs of life a pull should cause. */
+class Observer : public sim::LedListener, public sim::SerialDevice, public sim::PinListener {
+public:
+  unsigned long ledFrames = 0;
+  unsigned long audioBytes = 0;
+  unsigned long displaySelects = 0;
+
+  void frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) {
+    ledFrames++;
+  }
+  void receive(uint8_t b) {
+    audioBytes++;
+  }
+  void pinChanged(uint8_t pin, uint8_t level) {
+    if (pin == OLED_CS_PIN && level == LOW) displaySelects++;
+  }
+};
+
+struct Hour {
+  unsigned long pulls = 0;
+  unsigned long unanswered = 0;
+  unsigned long undrawn = 0;
+  unsigned long loops = 0;
+  unsigned long ledFrames = 0;
+  unsigned long audioBytes = 0;
+  unsigned long long busyMicros = 0;
+};
+
+Observer observer;
+std::vector<Hour> hours;
+unsigned long long mainStart = 0;
+
+Hour &currentHour() {
+  size_t h = (size_t)((sim::elapsedMicros() - mainStart) / HOUR);
+  if (h >= hours.size()) h = hours.size() - 1;
+  return hours[h];
+}
+
+/** Press a button for pressTime and check the firmware reacted to it. */
+void pull(uint8_t pin, unsigned long pressTime) {
+  currentHour().pulls++;
+  unsigned long leds = observer.ledFrames;
+  unsigned long audio = observer.audioBytes;
+  unsigned long display = observer.displaySelects;
+  sim::setInput(pin, LOW);
+  sim::scheduleAfter(pressTime * MS, [pin]() { sim::setInput(pin, -1); });
+  sim::scheduleAfter(ANSWER_WINDOW, [leds, audio]() {
+    if (observer.ledFrames == leds && observer.audioBytes == audio) currentHour().unanswered++;
+  });
+  // a shot (LED frames) has to show up on the ammo counter, an empty clip doesn't
+  sim::scheduleAfter(DISPLAY_WINDOW, [leds, display]() {
+    if (observer.ledFrames != leds && observer.displaySelects == display) currentHour().undrawn++;
+  });
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--hours H] [--shot-interval MS] [--press MS] [--reload-every N] [--wrap-after MS] [--step US]\n", name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long hourCnt = 8;
+  unsigned long shotInterval = 15000;
+  unsigned long pressTime = 250;
+  unsigned long reloadEvery = 20;
+  long wrapAfter = -1;
+  unsigned long step = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--hours") && i + 1 < argc) {
+      hourCnt = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--reload-every") && i + 1 < argc) {
+      reloadEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--wrap-after") && i + 1 < argc) {
+      wrapAfter = strtol(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--step") && i + 1 < argc) {
+      step = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (hourCnt == 0 || shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::setMaxIdleStep(step);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  if (wrapAfter >= 0) sim::setStartMillis((unsigned long)(0x100000000ULL - wrapAfter));
+
+  setup();
+  sim::addLedListener(&observer);
+  sim::addPinListener(&observer);
+  SoftwareSerial::onPin(AUDIO_RX_PIN)->attach(&observer);
+
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  unsigned long long startupUs = sim::elapsedMicros();
+
+  // line up the whole day of pulls
+  mainStart = sim::elapsedMicros();
+  hours.resize(hourCnt);
+  unsigned long long end = mainStart + hourCnt * HOUR;
+  unsigned long n = 0;
+  for (unsigned long long t = mainStart + shotInterval * MS; t < end; t += shotInterval * MS) {
+    bool isReload = reloadEvery && (++n % (reloadEvery + 1)) == 0;
+    uint8_t pin = isReload ? RELOAD_PIN : TRIGGER_PIN;
+    sim::schedule(t, [pin, pressTime]() { pull(pin, pressTime); });
+  }
+
+  unsigned long long lastIdle = sim::clockStats().idleMicros;
+  unsigned long long lastNow = sim::elapsedMicros();
+  unsigned long leds = observer.ledFrames, audio = observer.audioBytes;
+  while (sim::elapsedMicros() < end) {
+    loop();
+    Hour &h = currentHour();
+    h.loops++;
+    // time the clock didn't skip is time the firmware was busy
+    unsigned long long now = sim::elapsedMicros(), idle = sim::clockStats().idleMicros;
+    h.busyMicros += (now - lastNow) - (idle - lastIdle);
+    h.ledFrames += observer.ledFrames - leds;
+    h.audioBytes += observer.audioBytes - audio;
+    lastNow = now, lastIdle = idle;
+    leds = observer.ledFrames, audio = observer.audioBytes;
+  }
+  // let the last answer checks run
+  sim::advanceMicros(DISPLAY_WINDOW);
+
+  double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  Hour total;
+  printf("hour  pulls  unanswered  undrawn      loops  led frames  audio bytes  busy ms\n");
+  for (size_t i = 0; i < hours.size(); i++) {
+    const Hour &h = hours[i];
+    printf("%4u  %5lu  %10lu  %7lu  %9lu  %10lu  %11lu  %7llu\n", (unsigned)i + 1, h.pulls, h.unanswered, h.undrawn,
+           h.loops, h.ledFrames, h.audioBytes, h.busyMicros / MS);
+    total.pulls += h.pulls;
+    total.unanswered += h.unanswered;
+    total.undrawn += h.undrawn;
+  }
+  const sim::ClockStats &c = sim::clockStats();
+  double simSec = sim::elapsedMicros() / 1e6;
+  printf("start up:        %10.1f ms\n", startupUs / 1000.0);
+  printf("simulated:       %10.1f s in %.2f s wall (x%.0f)\n", simSec, wallSec, wallSec > 0 ? simSec / wallSec : 0.0);
+  printf("clock jumps:     %lu, %.1f s skipped idle\n", c.jumps, c.idleMicros / 1e6);
+  printf("millis() now:    %lu\n", millis());
+  printf("pulls:           %lu, %lu unanswered, %lu not drawn\n", total.pulls, total.unanswered, total.undrawn);
+  // a run without a single pull hasn't checked anything
+  return !total.pulls || total.unanswered || total.undrawn ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * Sustained fire rate of the Lawgiver firmware.
+ *
+ * Runs a build of the sketch with ENABLE_BENCH on the virtual clock, with a
+ * DFPlayer Mini and a VR3 on the serial links, and pulls the trigger at a
+ * steady cadence for --seconds at each rate in --rates (presses per second,
+ * held down for half of each period, the edges landing mid-pass if need be). ezButton only takes a press it has
+ * seen down on two passes of the loop 25 ms apart, and sending a track holds
+ * the loop for about 40 ms, so short presses can go unseen. For every rate it
+ * reports:
+ *   shots    presses handleAmmoDown() fired, from the BENCH_TRIGGER_PRESSED
+ *            mark, and the rate that makes
+ *   cut      shot patterns replaced by the next one before they finished,
+ *            from the BENCH_LED_CUT mark in EasyLedv3::activate()
+ *   redraws  main screen draws that ran
+ *   queued   the most redraws waiting in screenUpdates at once, and how many
+ *            were still waiting when the cadence stopped. The loop only
+ *            redraws when the LEDs are idle, so with a shot pattern running
+ *            all the time the queue only grows (and wraps at 256). With
+ *            ENABLE_OLED_PAGED (lawgiver_throughput_paged) the loop folds the
+ *            queue into one frame on the next pass, so it stays at 0.
+ *
+ * The clip is topped up after every press so each one that is seen fires a
+ * shot, lights the LEDs and queues a redraw, and the low ammo warning stays
+ * out of the way. Between rates the queue is left to drain.
+ *
+ * The ceiling is the best shots/s over all the rates. The run fails when it is
+ * under --target shots/s.
+ *
+ * Usage: lawgiver_throughput [--rates R,R,..] [--seconds S] [--mode N]
+ *                            [--target SHOTS_PER_S]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "config.h"
+#include "easycounter.h"
+#include "easyoled.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+typedef EasyOLED<OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN, OLED_RESET_PIN> Oled;
+
+void setup(void);
+void loop(void);
+void changeAmmoMode(int mode);
+EasyCounter &getTriggerCounter(void);
+extern uint8_t loopStage;
+extern volatile uint8_t screenUpdates;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const unsigned long long SETTLE = 2000 * MS;
+const unsigned long long DRAIN_LIMIT = 120000 * MS;
+
+/** Counts the firmware's marks. */
+class Probes : public sim::ProbeListener {
+public:
+  unsigned long shots = 0;
+  unsigned long cut = 0;
+  unsigned long redraws = 0;
+
+  void probeWritten(uint8_t value) {
+    if (value == BENCH_TRIGGER_PRESSED) shots++;
+    if (value == BENCH_LED_CUT) cut++;
+    if (value == ((BENCH_OLED_DRAW + Oled::DISPLAY_MAIN) | 0x80)) redraws++;
+  }
+
+  void reset() {
+    shots = cut = redraws = 0;
+  }
+};
+
+bool parseRates(const char *arg, std::vector<unsigned long> &rates) {
+  rates.clear();
+  while (*arg) {
+    char *end;
+    unsigned long rate = strtoul(arg, &end, 10);
+    if (end == arg || !rate || rate > 1000) return false;
+    rates.push_back(rate);
+    arg = *end == ',' ? end + 1 : end;
+    if (*end && *end != ',') return false;
+  }
+  return !rates.empty();
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--rates R,R,..] [--seconds S] [--mode N] [--target SHOTS_PER_S]\n", name);
+}
+
+void runUntil(unsigned long long until, uint8_t &maxQueued) {
+  while (sim::elapsedMicros() < until) {
+    loop();
+    if (screenUpdates > maxQueued) maxQueued = screenUpdates;
+  }
+}
+
+/** Runs until the queued redraws are done, so each rate starts from an idle loop. */
+void drain() {
+  uint8_t maxQueued = 0;
+  unsigned long long limit = sim::elapsedMicros() + DRAIN_LIMIT;
+  while (screenUpdates && sim::elapsedMicros() < limit) loop();
+  runUntil(sim::elapsedMicros() + SETTLE, maxQueued);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::vector<unsigned long> rates;
+  rates.push_back(5);
+  rates.push_back(10);
+  rates.push_back(20);
+  unsigned long seconds = 10;
+  int mode = VR_CMD_AMMO_MODE_FMJ;
+  double target = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--rates") && i + 1 < argc) {
+      if (!parseRates(argv[++i], rates)) {
+        usage(argv[0]);
+        return 2;
+      }
+    } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+      seconds = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+      mode = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--target") && i + 1 < argc) {
+      target = atof(argv[++i]);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (!seconds || mode < 0 || mode > VR_CMD_AMMO_MODE_RAPID) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+  Probes probes;
+  sim::addProbeListener(&probes);
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+  changeAmmoMode(mode);
+  drain();
+
+  printf("\nrate/s presses  shots shots/s    cut redraws max queued left queued\n");
+  double ceiling = 0;
+  for (size_t r = 0; r < rates.size(); r++) {
+    unsigned long long period = 1000 * MS / rates[r];
+    unsigned long presses = rates[r] * seconds;
+    probes.reset();
+    uint8_t maxQueued = 0;
+    unsigned long long start = sim::elapsedMicros();
+    for (unsigned long i = 0; i < presses; i++) {
+      // a finger isn't a clock: move each press a little so they don't
+      // all land on the same spot in the loop
+      unsigned long long at = start + i * period + (i % 4) * period / 16;
+      // the edges land when they're due, even in the middle of a pass
+      sim::schedule(at, []() { sim::setInput(TRIGGER_PIN, LOW); });
+      sim::schedule(at + period / 2, []() {
+        sim::setInput(TRIGGER_PIN, -1);
+        getTriggerCounter().resetCount();
+      });
+    }
+    runUntil(start + presses * period, maxQueued);
+    uint8_t left = screenUpdates;
+    double rate = probes.shots / (double)seconds;
+    if (rate > ceiling) ceiling = rate;
+    printf("%6lu %7lu %6lu %7.1f %6lu %7lu %10u %11u\n", rates[r], presses, probes.shots, rate, probes.cut,
+           probes.redraws, maxQueued, left);
+    fflush(stdout);
+    drain();
+  }
+  printf("ceiling %.1f shots/s", ceiling);
+  if (target > 0) printf(", target %.1f", target);
+  printf("\n");
+  return ceiling < target ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * Trace runner for the Lawgiver firmware.
+ *
+ * Runs a build of the sketch with ENABLE_DEBUG and ENABLE_TRACE on the virtual
+ * clock, with a DFPlayer Mini and a VR3 on the serial links. It walks the
+ * start up sequence, then pulls the trigger --shots times, one every
+ * --shot-interval ms, says an ammo mode word every --word-every shots and
+ * presses reload after every --reload-every shots. The firmware's debug port
+ * goes to stdout the same way it would reach a serial monitor, so the log
+ * feeds straight into trace2json:
+ *
+ *   lawgiver_trace > run.log && trace2json run.log run.json
+ *
+ * Usage: lawgiver_trace [--shots N] [--shot-interval MS] [--press MS]
+ *                       [--word-every N] [--reload-every N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern volatile uint8_t selectedAmmoMode;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const uint8_t MODE_CNT = 7;
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--shots N] [--shot-interval MS] [--press MS] [--word-every N] [--reload-every N]\n", name);
+}
+
+void press(uint8_t pin, unsigned long pressTime) {
+  sim::setInput(pin, LOW);
+  sim::scheduleAfter(pressTime * MS, [pin]() { sim::setInput(pin, -1); });
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long shots = 10;
+  unsigned long shotInterval = 1000;
+  unsigned long pressTime = 250;
+  unsigned long wordEvery = 4;
+  unsigned long reloadEvery = 5;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--shots") && i + 1 < argc) {
+      shots = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--shot-interval") && i + 1 < argc) {
+      shotInterval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--word-every") && i + 1 < argc) {
+      wordEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--reload-every") && i + 1 < argc) {
+      reloadEvery = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (shotInterval <= pressTime) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  VR3Model vr(VOICE_RX_PIN);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  unsigned long words = 0;
+  for (unsigned long i = 0; i < shots; i++) {
+    unsigned long long end = sim::elapsedMicros() + shotInterval * MS;
+    press(TRIGGER_PIN, pressTime);
+    if (wordEvery && (i + 1) % wordEvery == 0) {
+      // say it halfway to the next shot
+      uint8_t mode = (selectedAmmoMode + 1) % MODE_CNT;
+      vr.sayAt(sim::elapsedMicros() + shotInterval * MS / 2, mode);
+      words++;
+    }
+    while (sim::elapsedMicros() < end) loop();
+
+    if (reloadEvery && (i + 1) % reloadEvery == 0) {
+      end = sim::elapsedMicros() + shotInterval * MS;
+      press(RELOAD_PIN, pressTime);
+      while (sim::elapsedMicros() < end) loop();
+    }
+  }
+  fflush(stdout);
+  fprintf(stderr, "traced %.1f s: %lu shots, %lu words, %lu audio commands\n", sim::elapsedMicros() / 1e6, shots, words,
+          player.stats().commands);
+  return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * Voice command runner for the Lawgiver firmware.
+ *
+ * Puts the VR3 model on the voice link and a DFPlayer Mini on the audio link,
+ * boots the firmware, then says --commands ammo mode words, one every
+ * --interval ms with some jitter. Each word asks for a mode other than the
+ * selected one. A word counts as recognized when the firmware switches to that
+ * mode and sends the mode change track to the player. The latency runs from
+ * the last byte of the recognition frame to that first audio byte.
+ *
+ * --fire-every pulls the trigger on its own cadence at the same time, so the
+ * LED and audio traffic of the shots competes with the voice link. Every
+ * recognition frame that got mangled or lost on the way in shows up in the
+ * port's receive counters.
+ *
+ * Usage: lawgiver_voice [--commands N] [--interval MS] [--fire-every MS]
+ *                       [--press MS] [--recognize MS] [--seed N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "config.h"
+#include "sim.h"
+#include "firmware_timers.h"
+#include "dfplayer_model.h"
+#include "vr3_model.h"
+
+void setup(void);
+void loop(void);
+extern uint8_t loopStage;
+extern volatile uint8_t selectedAmmoMode;
+
+namespace {
+
+const unsigned long long MS = 1000ULL;
+const unsigned long long STARTUP_LIMIT = 60000 * MS;
+const uint8_t MODE_CNT = 7;
+
+/** Catches the first audio command after a recognized word. */
+class Reaction : public sim::SerialDevice {
+public:
+  DFPlayerMiniModel *player = 0;
+  bool waiting = false;
+  int expected = -1;
+  unsigned long long frameEnd = 0;
+  unsigned long recognized = 0;
+  unsigned long long total = 0;
+  unsigned long long min = ~0ULL;
+  unsigned long long max = 0;
+
+  void receive(uint8_t b) {
+    if (waiting && selectedAmmoMode == expected) {
+      waiting = false;
+      unsigned long long us = sim::elapsedMicros() - frameEnd;
+      recognized++;
+      total += us;
+      if (us < min) min = us;
+      if (us > max) max = us;
+    }
+    player->receive(b);
+  }
+};
+
+void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--commands N] [--interval MS] [--fire-every MS] [--press MS] [--recognize MS] [--seed N]\n",
+          name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long commands = 50;
+  unsigned long interval = 3000;
+  unsigned long fireEvery = 0;
+  unsigned long pressTime = 250;
+  unsigned long recognize = 100;
+  unsigned long seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--commands") && i + 1 < argc) {
+      commands = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--interval") && i + 1 < argc) {
+      interval = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--fire-every") && i + 1 < argc) {
+      fireEvery = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+      pressTime = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--recognize") && i + 1 < argc) {
+      recognize = strtoul(argv[++i], 0, 10);
+    } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+      seed = strtoul(argv[++i], 0, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (interval < 1000 || (fireEvery && fireEvery <= pressTime)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim::setClockMode(sim::VIRTUAL_CLOCK);
+  sim::addDeadlineSource(&firmwareTimers());
+
+  DFPlayerMiniModel player(AUDIO_RX_PIN);
+  Reaction reaction;
+  reaction.player = &player;
+  VR3Model vr(VOICE_RX_PIN);
+  vr.setRecognizeMillis(recognize);
+  if (!player.attach() || !vr.attach()) {
+    fprintf(stderr, "missing serial port for the audio or voice link\n");
+    return 1;
+  }
+  // sit between the sketch and the player to see its commands first
+  SoftwareSerial::onPin(AUDIO_RX_PIN)->attach(&reaction);
+
+  setup();
+  // hold the trigger through the start up sequence to pass the DNA check
+  sim::setInput(TRIGGER_PIN, LOW);
+  while (loopStage == LOOP_STATE_START && sim::elapsedMicros() < STARTUP_LIMIT) loop();
+  sim::setInput(TRIGGER_PIN, -1);
+  if (loopStage != LOOP_STATE_MAIN) {
+    fprintf(stderr, "start up sequence failed, loop stage %d\n", loopStage);
+    return 1;
+  }
+
+  SoftwareSerial *port = SoftwareSerial::onPin(VOICE_RX_PIN);
+  SoftwareSerial::RxStats rxBefore = port->rxStats();
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned long> jitter(0, interval / 2);
+  unsigned long long start = sim::elapsedMicros();
+  unsigned long long end = start + commands * interval * MS;
+
+  if (fireEvery) {
+    for (unsigned long long t = start + fireEvery * MS; t < end; t += fireEvery * MS) {
+      sim::schedule(t, [pressTime]() {
+        sim::setInput(TRIGGER_PIN, LOW);
+        sim::scheduleAfter(pressTime * MS, []() { sim::setInput(TRIGGER_PIN, -1); });
+      });
+    }
+  }
+
+  unsigned long said = 0;
+  for (unsigned long i = 0; i < commands; i++) {
+    unsigned long long slot = start + i * interval * MS;
+    unsigned long long at = slot + jitter(rng) * MS;
+    while (sim::elapsedMicros() < at) loop();
+
+    // pick a mode other than the selected one, so the switch is visible
+    int mode = (selectedAmmoMode + 1 + rng() % (MODE_CNT - 1)) % MODE_CNT;
+    reaction.expected = mode;
+    reaction.waiting = true;
+    reaction.frameEnd = vr.say(mode);
+    said++;
+
+    unsigned long long next = slot + interval * MS;
+    while (sim::elapsedMicros() < next) loop();
+    reaction.waiting = false;
+  }
+
+  const SoftwareSerial::RxStats &rx = port->rxStats();
+  unsigned long lost = said - reaction.recognized;
+  printf("words said:      %lu, %lu recognized, %lu lost (%.1f%%)\n", said, reaction.recognized, lost,
+         said ? lost * 100.0 / said : 0.0);
+  if (reaction.recognized) {
+    printf("latency:         min %.1f ms, avg %.1f ms, max %.1f ms (frame end to mode change track)\n",
+           reaction.min / 1000.0, reaction.total / 1000.0 / reaction.recognized, reaction.max / 1000.0);
+  }
+  printf("voice link rx:   %lu bytes sent, %lu received, %lu corrupted, %lu missed, %lu dropped\n",
+         vr.stats().bytes, rx.received - rxBefore.received, rx.corrupted - rxBefore.corrupted,
+         rx.missed - rxBefore.missed, rx.dropped - rxBefore.dropped);
+  const sim::Counters &c = sim::counters();
+  printf("blackouts:       %lu, longest %lu us\n", c.blackouts, c.longestBlackoutMicros);
+  return 0;
+}
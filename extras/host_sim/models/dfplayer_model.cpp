@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+
+#include "dfplayer_model.h"
+
+static const unsigned long long MS = 1000ULL;
+
+// Rough figures for the modules on the bench: the Mini reads the SD card for
+// about 1.5 s after power on, the Pro mounts its flash a little quicker.
+const DFPlayerModel::Timing DFPlayerMiniModel::DEFAULT_TIMING = {1500, 10, 40};
+const DFPlayerModel::Timing DFPlayerProModel::DEFAULT_TIMING = {1000, 20, 60};
+
+DFPlayerModel::DFPlayerModel(uint8_t rxPin, const Timing &timing) : _timing(timing), _volume(25), _rxPin(rxPin) {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+bool DFPlayerModel::attach() {
+  _port = SoftwareSerial::onPin(_rxPin);
+  if (!_port) return false;
+  _port->attach(this);
+  powerOn();
+  return true;
+}
+
+void DFPlayerModel::setBusyPin(uint8_t pin) {
+  _busyPin = pin;
+  sim::setInput(pin, _playing ? LOW : HIGH);
+}
+
+bool DFPlayerModel::booted() const {
+  return sim::elapsedMicros() >= _bootDone;
+}
+
+void DFPlayerModel::powerOn() {
+  _playId++;
+  setPlaying(false);
+  _bootDone = sim::elapsedMicros() + _timing.boot * MS;
+}
+
+void DFPlayerModel::reply(const uint8_t *data, int len) {
+  if (!_port || _port->baud() == 0) return;
+  unsigned long long byteTime = 10000000ULL / _port->baud();
+  unsigned long long t = sim::elapsedMicros() + _timing.reply * MS;
+  if (t < _replyFree) t = _replyFree;
+  SoftwareSerial *port = _port;
+  for (int i = 0; i < len; i++) {
+    uint8_t b = data[i];
+    sim::schedule(t, [port, b]() { port->startReceive(b); });
+    t += byteTime;
+  }
+  _replyFree = t;
+  _stats.replyBytes += len;
+}
+
+void DFPlayerModel::play(int track) {
+  stop();
+  unsigned long id = _playId;
+  sim::scheduleAfter(_timing.playStart * MS, [this, id, track]() {
+    if (id != _playId) return;
+    _track = track;
+    setPlaying(true);
+    _stats.tracksStarted++;
+    if (_listener) _listener->trackStarted(track);
+
+    std::map<int, unsigned long>::const_iterator it = _trackMillis.find(track);
+    unsigned long length = it != _trackMillis.end() ? it->second : _defaultTrackMillis;
+    sim::scheduleAfter(length * MS, [this, id, track]() {
+      if (id != _playId) return;
+      _playId++;
+      setPlaying(false);
+      _stats.tracksFinished++;
+      if (_listener) _listener->trackStopped(track, true);
+      trackFinished(track);
+    });
+  });
+}
+
+void DFPlayerModel::stop() {
+  _playId++;
+  if (!_playing) return;
+  setPlaying(false);
+  _stats.tracksCut++;
+  if (_listener) _listener->trackStopped(_track, false);
+}
+
+void DFPlayerModel::setPlaying(bool playing) {
+  _playing = playing;
+  if (_busyPin >= 0) sim::setInput(_busyPin, playing ? LOW : HIGH);
+}
+
+// ---------------------------------------------------------------------------
+// DFPlayer Mini
+// ---------------------------------------------------------------------------
+
+DFPlayerMiniModel::DFPlayerMiniModel(uint8_t rxPin, const Timing &timing) : DFPlayerModel(rxPin, timing) {
+  memset(_packet, 0, sizeof(_packet));
+}
+
+void DFPlayerMiniModel::powerOn() {
+  DFPlayerModel::powerOn();
+  // "online, SD card" once the card has been read
+  sim::scheduleAfter(_timing.boot * MS, [this]() { sendPacket(0x3F, 0x0002); });
+}
+
+void DFPlayerMiniModel::receive(uint8_t b) {
+  if (_len == 0 && b != 0x7E) {
+    _stats.badCommands++;
+    return;
+  }
+  _packet[_len++] = b;
+  if (_len < 8) return;
+
+  uint8_t *p = _packet;
+  if (p[1] != 0xFF || p[2] != 0x06) {
+    _stats.badCommands++;
+    _len = 0;
+    return;
+  }
+  // variants without the checksum end right after the parameter
+  if (_len == 8 && p[7] == 0xEF) {
+    _len = 0;
+    packetReceived(p[3], p[4], (p[5] << 8) | p[6]);
+    return;
+  }
+  if (_len < 10) return;
+  _len = 0;
+  uint16_t sum = -(p[1] + p[2] + p[3] + p[4] + p[5] + p[6]);
+  if (p[9] != 0xEF || p[7] != (sum >> 8) || p[8] != (sum & 0xFF)) {
+    _stats.badCommands++;
+    return;
+  }
+  packetReceived(p[3], p[4], (p[5] << 8) | p[6]);
+}
+
+void DFPlayerMiniModel::packetReceived(uint8_t cmd, bool feedback, uint16_t param) {
+  if (!booted()) {
+    _stats.ignored++;
+    return;
+  }
+  _stats.commands++;
+  switch (cmd) {
+    case 0x01:  // next
+      play(currentTrack() + 1);
+      break;
+    case 0x02:  // previous
+      play(currentTrack() > 1 ? currentTrack() - 1 : 1);
+      break;
+    case 0x03:  // track in the root folder
+    case 0x12:  // track in the MP3 folder
+      play(param);
+      break;
+    case 0x04:
+      if (_volume < 30) _volume++;
+      break;
+    case 0x05:
+      if (_volume > 0) _volume--;
+      break;
+    case 0x06:
+      if (param <= 30) _volume = param;
+      break;
+    case 0x0C:  // reset
+      powerOn();
+      return;
+    case 0x0D:  // resume
+      if (!isPlaying()) play(currentTrack());
+      break;
+    case 0x0E:  // pause
+    case 0x16:  // stop
+      stop();
+      break;
+    case 0x42:  // status: SD card, playing or stopped
+      sendPacket(0x42, 0x0200 | (isPlaying() ? 1 : 0));
+      break;
+    case 0x43:
+      sendPacket(0x43, _volume);
+      break;
+    default:
+      _stats.commands--;
+      _stats.badCommands++;
+      return;
+  }
+  if (feedback) sendPacket(0x41, 0);
+}
+
+void DFPlayerMiniModel::trackFinished(int track) {
+  sendPacket(0x3D, track);
+}
+
+void DFPlayerMiniModel::sendPacket(uint8_t cmd, uint16_t param) {
+  uint8_t p[10] = {0x7E, 0xFF, 0x06, cmd, 0x00, (uint8_t)(param >> 8), (uint8_t)param, 0, 0, 0xEF};
+  uint16_t sum = -(p[1] + p[2] + p[3] + p[4] + p[5] + p[6]);
+  p[7] = sum >> 8;
+  p[8] = sum & 0xFF;
+  reply(p, sizeof(p));
+}
+
+// ---------------------------------------------------------------------------
+// DFPlayer Pro
+// ---------------------------------------------------------------------------
+
+DFPlayerProModel::DFPlayerProModel(uint8_t rxPin, const Timing &timing) : DFPlayerModel(rxPin, timing) {
+}
+
+void DFPlayerProModel::receive(uint8_t b) {
+  if (b == '\n') {
+    if (!_line.empty() && _line[_line.size() - 1] == '\r') _line.erase(_line.size() - 1);
+    lineReceived(_line);
+    _line.clear();
+  } else if (_line.size() < 64) {
+    _line += (char)b;
+  }
+}
+
+void DFPlayerProModel::lineReceived(const std::string &line) {
+  if (!booted()) {
+    _stats.ignored++;
+    return;
+  }
+  std::string name = line, value;
+  size_t eq = line.find('=');
+  if (eq != std::string::npos) {
+    name = line.substr(0, eq);
+    value = line.substr(eq + 1);
+  }
+  int n = atoi(value.c_str());
+
+  bool ok = true;
+  if (name == "AT") {
+  } else if (name == "AT+VOL" && !value.empty() && n >= 0 && n <= 30) {
+    _volume = n;
+  } else if (name == "AT+AMP" && (value == "ON" || value == "OFF")) {
+    _ampOn = value == "ON";
+  } else if (name == "AT+FUNCTION" && n >= 1 && n <= 3) {
+    _function = n;
+    stop();
+  } else if (name == "AT+PLAYMODE" && n >= 1 && n <= 5) {
+    _playMode = n;
+  } else if (name == "AT+PLAYNUM" && n > 0) {
+    play(n);
+  } else if (name == "AT+PLAY" && value == "PP") {
+    if (isPlaying()) stop();
+    else play(currentTrack());
+  } else if (name == "AT+QUERY" && value == "1") {
+    replyText(isPlaying() ? "1\r\n" : "0\r\n");
+    _stats.commands++;
+    return;
+  } else {
+    ok = false;
+  }
+
+  if (ok) {
+    _stats.commands++;
+    replyText("OK\r\n");
+  } else {
+    _stats.badCommands++;
+    replyText("error\r\n");
+  }
+}
+
+void DFPlayerProModel::replyText(const char *text) {
+  reply((const uint8_t *)text, strlen(text));
+}
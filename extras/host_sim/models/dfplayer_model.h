@@ -0,0 +1,174 @@
+#ifndef dfplayer_model_h
+#define dfplayer_model_h
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include <SoftwareSerial.h>
+#include "sim.h"
+
+/**
+ * Host model of a DFPlayer audio module on the end of a SoftwareSerial link.
+ *
+ * Holds what both variants have in common: a boot time during which commands
+ * are ignored, the delay before a reply goes back, the delay between a play
+ * command and sound coming out of the speaker, track lengths and the
+ * busy / playing state. Replies go out on the sketch's RX pin back to back at
+ * the port's baud rate, through SoftwareSerial::startReceive(). The BUSY pin can be driven too (low
+ * while playing), even though the prop doesn't wire it up.
+ *
+ * The protocols live in DFPlayerMiniModel and DFPlayerProModel below.
+ *
+ * eg. DFPlayerMiniModel player(AUDIO_RX_PIN);
+ * eg. player.setTrackMillis(AUDIO_TRACK_FMJ_FIRE, 900);
+ * eg. player.attach();
+ */
+class DFPlayerModel : public sim::SerialDevice {
+public:
+  /**
+   * Delays the module takes, in milliseconds.
+   *   boot      - power on until commands are accepted
+   *   reply     - command received until the reply starts
+   *   playStart - play command received until sound comes out
+   */
+  struct Timing {
+    unsigned long boot;
+    unsigned long reply;
+    unsigned long playStart;
+  };
+
+  /**
+   * Notified when a track starts or stops making sound.
+   */
+  class PlaybackListener {
+  public:
+    virtual ~PlaybackListener() {}
+    virtual void trackStarted(int track) = 0;
+    virtual void trackStopped(int track, bool finished) {}
+  };
+
+  /**
+   * What the module saw.
+   */
+  struct Stats {
+    unsigned long commands;       // commands understood
+    unsigned long ignored;        // commands sent while booting
+    unsigned long badCommands;    // framing, checksum or syntax errors
+    unsigned long tracksStarted;
+    unsigned long tracksFinished;
+    unsigned long tracksCut;      // stopped by another play command
+    unsigned long replyBytes;
+  };
+
+  DFPlayerModel(uint8_t rxPin, const Timing &timing);
+  virtual ~DFPlayerModel() {}
+
+  /**
+   * Connect to the firmware's port with the given RX pin and power the
+   * module on. Returns false if the firmware has no such port.
+   */
+  bool attach();
+
+  void setTrackMillis(int track, unsigned long ms) { _trackMillis[track] = ms; }
+  void setDefaultTrackMillis(unsigned long ms) { _defaultTrackMillis = ms; }
+  void setTiming(const Timing &timing) { _timing = timing; }
+  void setPlaybackListener(PlaybackListener *listener) { _listener = listener; }
+  /** Drive pin low while a track is playing, like the module's BUSY output. */
+  void setBusyPin(uint8_t pin);
+
+  bool booted() const;
+  bool isPlaying() const { return _playing; }
+  int currentTrack() const { return _track; }
+  uint8_t volume() const { return _volume; }
+  const Stats &stats() const { return _stats; }
+
+protected:
+  Timing _timing;
+  uint8_t _volume;
+  Stats _stats;
+
+  /** Send bytes back to the sketch, starting reply ms from now. */
+  void reply(const uint8_t *data, int len);
+  /** Start a track playStart ms from now, cutting off whatever plays. */
+  void play(int track);
+  void stop();
+  /** Power on or reset, commands are ignored for the boot time. */
+  virtual void powerOn();
+  /** Called when a track runs to its end. */
+  virtual void trackFinished(int track) {}
+
+private:
+  uint8_t _rxPin;
+  SoftwareSerial *_port = 0;
+  PlaybackListener *_listener = 0;
+  int _busyPin = -1;
+  std::map<int, unsigned long> _trackMillis;
+  unsigned long _defaultTrackMillis = 1000;
+  unsigned long long _bootDone = 0;
+  unsigned long long _replyFree = 0;   // when the reply line is free again
+  bool _playing = false;
+  int _track = 0;
+  unsigned long _playId = 0;           // invalidates scheduled starts / ends of older plays
+
+  void setPlaying(bool playing);
+};
+
+/**
+ * DFPlayer Mini (YX5200 / MH2024K) speaking the 10 byte binary protocol:
+ *   0x7E 0xFF 0x06 cmd feedback paramMSB paramLSB checksumMSB checksumLSB 0xEF
+ * The checksum is left out by some chip variants, packets without it are
+ * accepted too. Sends the 0x41 acknowledge when feedback is asked for, answers
+ * the status (0x42) and volume (0x43) queries, reports 0x3F (online) after
+ * boot and 0x3D when a track finishes, the way DFPlayerMini_Fast's
+ * parseFeedback() expects them.
+ */
+class DFPlayerMiniModel : public DFPlayerModel {
+public:
+  static const Timing DEFAULT_TIMING;
+
+  DFPlayerMiniModel(uint8_t rxPin, const Timing &timing = DEFAULT_TIMING);
+
+  void receive(uint8_t b);
+
+protected:
+  void powerOn();
+  void trackFinished(int track);
+
+private:
+  uint8_t _packet[10];
+  uint8_t _len = 0;
+
+  void packetReceived(uint8_t cmd, bool feedback, uint16_t param);
+  void sendPacket(uint8_t cmd, uint16_t param);
+};
+
+/**
+ * DFPlayer Pro (DF1201S) speaking its AT command set over a line protocol,
+ * eg. "AT+PLAYNUM=5\r\n" answered by "OK\r\n". Understands the commands the
+ * sketch's DFPlayerPro sends (AT, AT+VOL, AT+AMP, AT+FUNCTION, AT+PLAYMODE,
+ * AT+PLAYNUM) plus AT+PLAY=PP and AT+QUERY=1. Anything else gets "error".
+ */
+class DFPlayerProModel : public DFPlayerModel {
+public:
+  static const Timing DEFAULT_TIMING;
+
+  DFPlayerProModel(uint8_t rxPin, const Timing &timing = DEFAULT_TIMING);
+
+  void receive(uint8_t b);
+
+  bool ampOn() const { return _ampOn; }
+  int function() const { return _function; }
+  int playMode() const { return _playMode; }
+
+private:
+  std::string _line;
+  bool _ampOn = false;
+  int _function = 1;
+  int _playMode = 1;
+
+  void lineReceived(const std::string &line);
+  void replyText(const char *text);
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "sh1122_model.h"
+
+SH1122Model::SH1122Model(uint8_t clockPin, uint8_t dataPin, uint8_t csPin, uint8_t dcPin)
+  : _clockPin(clockPin), _dataPin(dataPin), _csPin(csPin), _dcPin(dcPin) {
+  memset(_ram, 0, sizeof(_ram));
+  memset(&_total, 0, sizeof(_total));
+  memset(&_frameStart, 0, sizeof(_frameStart));
+  memset(&_frameEnd, 0, sizeof(_frameEnd));
+  memset(&_lastFrame, 0, sizeof(_lastFrame));
+}
+
+void SH1122Model::attach() {
+  sim::addPinListener(this);
+  SPI.attach(this);
+}
+
+void SH1122Model::pinChanged(uint8_t pin, uint8_t level) {
+  if (pin == _csPin) {
+    if (level == LOW) {
+      // a new transfer always starts on a byte boundary
+      _bits = 0;
+      _shift = 0;
+      _total.transfers++;
+      // after a pause, the last frame only updated some rows
+      if (_inFrame && sim::elapsedMicros() > _frameEnd.endMicros + FRAME_GAP_MICROS) finishFrame();
+    } else {
+      endTransfer();
+    }
+    return;
+  }
+  if (pin != _clockPin || level != HIGH) return;
+  if (sim::outputLevel(_csPin) != LOW) return;
+
+  _total.clocks++;
+  _shift = (_shift << 1) | (sim::outputLevel(_dataPin) ? 1 : 0);
+  if (++_bits == 8) {
+    byteReceived(_shift, sim::outputLevel(_dcPin) == HIGH);
+    _bits = 0;
+    _shift = 0;
+  }
+}
+
+uint8_t SH1122Model::transfer(uint8_t b) {
+  if (sim::outputLevel(_csPin) != LOW) return 0xFF;
+  _total.clocks += 8;
+  byteReceived(b, sim::outputLevel(_dcPin) == HIGH);
+  // the SH1122 has no data out
+  return 0xFF;
+}
+
+void SH1122Model::byteReceived(uint8_t b, bool data) {
+  if (!data) {
+    _total.commandBytes++;
+    if (_pendingCommand) {
+      commandArg(_pendingCommand, b);
+      _pendingCommand = 0;
+    } else {
+      command(b);
+    }
+    return;
+  }
+  _total.dataBytes++;
+  _ram[_row][_column] = b;
+  _column = (_column + 1) & 0x7F;
+  if (_row == HEIGHT - 1) _lastRowWritten = true;
+}
+
+void SH1122Model::command(uint8_t c) {
+  if (c <= 0x0F) {
+    _column = (_column & 0x70) | c;
+  } else if (c <= 0x17) {
+    _column = ((c & 0x07) << 4) | (_column & 0x0F);
+  } else if (c >= 0x30 && c <= 0x3F) {
+    // discharge / pre-charge level, nothing to model
+  } else if (c >= 0x40 && c <= 0x7F) {
+    _startLine = c & 0x3F;
+  } else {
+    switch (c) {
+      case 0x81:  // contrast
+      case 0xA8:  // multiplex ratio
+      case 0xAD:  // DC-DC control
+      case 0xB0:  // row address
+      case 0xD3:  // display offset
+      case 0xD5:  // clock divide
+      case 0xD9:  // discharge / pre-charge period
+      case 0xDB:  // VCOM deselect level
+      case 0xDC:  // VSEGM level
+        _pendingCommand = c;
+        break;
+      case 0xA0:
+      case 0xA1:
+        _segmentRemap = c & 1;
+        break;
+      case 0xA4:
+      case 0xA5:
+        break;
+      case 0xA6:
+      case 0xA7:
+        _reverse = c & 1;
+        break;
+      case 0xAE:
+      case 0xAF:
+        _displayOn = c & 1;
+        break;
+      case 0xC0:
+      case 0xC8:
+        _comRemap = c & 0x08;
+        break;
+      case 0xE0:  // read-modify-write
+      case 0xEE:  // end
+      case 0xE3:  // nop
+        break;
+      default:
+        _unknownCommands++;
+        break;
+    }
+  }
+}
+
+void SH1122Model::commandArg(uint8_t c, uint8_t arg) {
+  switch (c) {
+    case 0x81:
+      _contrast = arg;
+      break;
+    case 0xB0:
+      // back to a row already sent, the last frame only updated some rows
+      if (_inFrame && (arg & 0x3F) <= _row) finishFrame();
+      _row = arg & 0x3F;
+      if (!_inFrame) {
+        _inFrame = true;
+        _lastRowWritten = false;
+        _frameStart = _total;
+        // the row address command and its argument belong to the frame
+        _frameStart.commandBytes -= 2;
+        _frameStart.clocks -= 16;
+        _frameStart.startMicros = sim::elapsedMicros();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void SH1122Model::endTransfer() {
+  if (!_inFrame) return;
+  _frameEnd = _total;
+  _frameEnd.endMicros = sim::elapsedMicros();
+  if (_lastRowWritten) finishFrame();
+}
+
+void SH1122Model::endFrame() {
+  if (_inFrame) finishFrame();
+}
+
+void SH1122Model::finishFrame() {
+  _inFrame = false;
+  _frames++;
+  _lastFrame.commandBytes = _frameEnd.commandBytes - _frameStart.commandBytes;
+  _lastFrame.dataBytes = _frameEnd.dataBytes - _frameStart.dataBytes;
+  _lastFrame.clocks = _frameEnd.clocks - _frameStart.clocks;
+  // the transfer that addressed the first row was counted before the frame started
+  _lastFrame.transfers = _frameEnd.transfers - _frameStart.transfers + 1;
+  _lastFrame.startMicros = _frameStart.startMicros;
+  _lastFrame.endMicros = _frameEnd.endMicros;
+  if (_listener) _listener->frameDone(*this, _lastFrame);
+}
+
+uint8_t SH1122Model::ramPixel(int x, int y) const {
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return 0;
+  uint8_t b = _ram[y][x / 2];
+  return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+uint8_t SH1122Model::pixel(int x, int y) const {
+  if (!_displayOn) return 0;
+  int rx = _segmentRemap ? WIDTH - 1 - x : x;
+  int com = _comRemap ? HEIGHT - 1 - y : y;
+  uint8_t level = ramPixel(rx, (com + _startLine) % HEIGHT);
+  return _reverse ? 15 - level : level;
+}
+
+bool SH1122Model::writePgm(const char *path, bool upsideDown) const {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P5\n%d %d\n15\n", WIDTH, HEIGHT);
+  for (int y = 0; y < HEIGHT; y++) {
+    for (int x = 0; x < WIDTH; x++) {
+      fputc(upsideDown ? pixel(WIDTH - 1 - x, HEIGHT - 1 - y) : pixel(x, y), f);
+    }
+  }
+  return fclose(f) == 0;
+}
+
+long SH1122Model::comparePgm(const char *path, bool upsideDown) const {
+  FILE *f = fopen(path, "rb");
+  if (!f) return -1;
+  int w = 0, h = 0, maxval = 0;
+  // a single whitespace byte separates the header from the pixels
+  if (fscanf(f, "P5 %d %d %d", &w, &h, &maxval) != 3 || w != WIDTH || h != HEIGHT || fgetc(f) == EOF) {
+    fclose(f);
+    return -1;
+  }
+  long diff = 0;
+  for (int y = 0; y < HEIGHT; y++) {
+    for (int x = 0; x < WIDTH; x++) {
+      int c = fgetc(f);
+      if (c == EOF) {
+        fclose(f);
+        return -1;
+      }
+      if (c != (upsideDown ? pixel(WIDTH - 1 - x, HEIGHT - 1 - y) : pixel(x, y))) diff++;
+    }
+  }
+  fclose(f);
+  return diff;
+}
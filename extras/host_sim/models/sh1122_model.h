@@ -0,0 +1,143 @@
+#ifndef sh1122_model_h
+#define sh1122_model_h
+
+#include <stdint.h>
+
+#include "sim.h"
+
+/**
+ * Host model of the SH1122 256x64 16 gray level OLED controller on its
+ * 4-wire SPI port.
+ *
+ * The model watches the clock, data, chip select and data/command pins the
+ * sketch bit-bangs through u8x8_byte_4wire_sw_spi and decodes the stream the
+ * way the controller does: bits are taken on the rising clock edge while CS
+ * is low, MSB first, and DC picks command (low) or display data (high).
+ * With ENABLE_OLED_HW_SPI the bytes come from the hardware SPI port instead,
+ * DC and CS are still pins. The command set used by u8x8_d_sh1122 is
+ * understood (row address 0xB0, column address 0x00/0x10, remap, start line,
+ * contrast, display on/off) and data bytes land in display RAM two 4 bit
+ * pixels at a time.
+ *
+ * Frames are counted the way U8g2 sends them, rows in ascending order: a
+ * frame starts when a row is addressed and is done when the transfer that
+ * filled row 63 ends. A frame that only updates some rows, like EasyOLED's
+ * main screen after a shot, never gets there; it is done when the next one
+ * addresses a row at or above its last, starts after the bus was idle for
+ * over a millisecond, or on endFrame(). Each finished frame reports its bus
+ * cost, which makes one EasyOLED::drawDisplay() one frame, and each page
+ * EasyOLED::updatePage() sends one frame of its own.
+ *
+ * eg. SH1122Model oled(OLED_SCL_PIN, OLED_SDA_PIN, OLED_CS_PIN, OLED_DC_PIN);
+ * eg. oled.attach();
+ * eg. ... run the firmware ...
+ * eg. oled.lastFrame().dataBytes;
+ */
+class SH1122Model : public sim::PinListener, public sim::SpiDevice {
+public:
+  static const int WIDTH = 256;
+  static const int HEIGHT = 64;
+  static const unsigned long FRAME_GAP_MICROS = 1000;
+
+  /**
+   * Bus traffic, either for one frame or since the model was attached.
+   */
+  struct Stats {
+    unsigned long commandBytes;
+    unsigned long dataBytes;
+    unsigned long clocks;        // rising clock edges with CS low
+    unsigned long transfers;     // CS low to high cycles
+    unsigned long long startMicros;
+    unsigned long long endMicros;
+
+    unsigned long bytes() const { return commandBytes + dataBytes; }
+    unsigned long long micros() const { return endMicros - startMicros; }
+  };
+
+  /**
+   * Notified when a frame has been sent in full.
+   */
+  class FrameListener {
+  public:
+    virtual ~FrameListener() {}
+    virtual void frameDone(const SH1122Model &model, const Stats &frame) = 0;
+  };
+
+  SH1122Model(uint8_t clockPin, uint8_t dataPin, uint8_t csPin, uint8_t dcPin);
+
+  /** Start listening to the pins and the SPI port. */
+  void attach();
+  void setFrameListener(FrameListener *listener) { _listener = listener; }
+
+  void pinChanged(uint8_t pin, uint8_t level);
+  uint8_t transfer(uint8_t b);
+
+  /** Gray level (0 - 15) held in display RAM. */
+  uint8_t ramPixel(int x, int y) const;
+  /**
+   * Gray level (0 - 15) as seen on the glass, with the segment / COM remap
+   * and display start line applied. Blank while the display is off.
+   */
+  uint8_t pixel(int x, int y) const;
+
+  bool displayOn() const { return _displayOn; }
+  uint8_t contrast() const { return _contrast; }
+
+  const Stats &total() const { return _total; }
+  const Stats &lastFrame() const { return _lastFrame; }
+  unsigned long frames() const { return _frames; }
+  /** Finish a frame that only updated some rows, eg. at the end of a run. */
+  void endFrame();
+  /** Commands the model doesn't know, a hint the driver changed. */
+  unsigned long unknownCommands() const { return _unknownCommands; }
+
+  /**
+   * Write what's on the glass as a binary PGM (16 gray levels). Pass
+   * upsideDown for a panel mounted rotated by 180 degrees, like the one in
+   * the prop (the firmware draws with U8G2_R2 to match).
+   * Returns false if the file can't be written.
+   */
+  bool writePgm(const char *path, bool upsideDown = false) const;
+
+  /**
+   * Compare what's on the glass with a PGM written by writePgm(). Returns the
+   * number of pixels that differ, or -1 if the file can't be read or isn't a
+   * 256x64 PGM.
+   */
+  long comparePgm(const char *path, bool upsideDown = false) const;
+
+private:
+  uint8_t _clockPin, _dataPin, _csPin, _dcPin;
+  FrameListener *_listener = 0;
+
+  uint8_t _ram[HEIGHT][WIDTH / 2];  // two pixels per byte, left pixel in the high nibble
+  uint8_t _row = 0;
+  uint8_t _column = 0;              // in bytes, 0 - 127
+  uint8_t _startLine = 0;
+  bool _segmentRemap = false;
+  bool _comRemap = false;
+  bool _displayOn = false;
+  bool _reverse = false;
+  uint8_t _contrast = 0x80;
+
+  uint8_t _shift = 0;
+  uint8_t _bits = 0;
+  uint8_t _pendingCommand = 0;      // two byte command waiting for its argument
+
+  Stats _total;
+  Stats _frameStart;                // _total when the current frame started
+  Stats _frameEnd;                  // _total when its last transfer ended
+  Stats _lastFrame;
+  bool _inFrame = false;
+  bool _lastRowWritten = false;
+  unsigned long _frames = 0;
+  unsigned long _unknownCommands = 0;
+
+  void byteReceived(uint8_t b, bool data);
+  void command(uint8_t c);
+  void commandArg(uint8_t c, uint8_t arg);
+  void endTransfer();
+  void finishFrame();
+};
+
+#endif
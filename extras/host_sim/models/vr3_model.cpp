@@ -0,0 +1,53 @@
+#include <Arduino.h>
+
+#include "vr3_model.h"
+
+VR3Model::VR3Model(uint8_t rxPin) : _rxPin(rxPin) {
+}
+
+bool VR3Model::attach() {
+  _port = SoftwareSerial::onPin(_rxPin);
+  if (!_port) return false;
+  _port->attach(this);
+  return true;
+}
+
+unsigned long long VR3Model::say(uint8_t record) {
+  return sayAt(sim::elapsedMicros(), record);
+}
+
+unsigned long long VR3Model::sayAt(unsigned long long atMicros, uint8_t record) {
+  // group, record, recognizer index (records load in order), no signature
+  uint8_t data[5] = {0x00, GROUP_NONE, record, record, 0x00};
+  return sendFrameAt(atMicros + _recognizeMillis * 1000ULL, FRAME_CMD_VR, data, sizeof(data));
+}
+
+unsigned long long VR3Model::sendFrameAt(unsigned long long atMicros, uint8_t cmd, const uint8_t *data, uint8_t len) {
+  // the module runs at its factory 9600 baud until the sketch says otherwise
+  long baud = _port && _port->baud() ? _port->baud() : 9600;
+  unsigned long long byteTime = 10000000ULL / baud;
+  unsigned long long t = atMicros > _lineFree ? atMicros : _lineFree;
+  SoftwareSerial *port = _port;
+
+  uint8_t frame[40];
+  uint8_t n = 0;
+  frame[n++] = FRAME_HEAD;
+  frame[n++] = len + 2;  // cmd, data and the end byte
+  frame[n++] = cmd;
+  for (uint8_t i = 0; i < len && n < sizeof(frame) - 1; i++) frame[n++] = data[i];
+  frame[n++] = FRAME_END;
+
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t b = frame[i];
+    if (port) sim::schedule(t, [port, b]() { port->startReceive(b); });
+    t += byteTime;
+  }
+  _lineFree = t;
+  _stats.frames++;
+  _stats.bytes += n;
+  return t;
+}
+
+void VR3Model::receive(uint8_t b) {
+  _stats.commandBytes++;
+}
@@ -0,0 +1,68 @@
+#ifndef vr3_model_h
+#define vr3_model_h
+
+#include <stdint.h>
+
+#include <SoftwareSerial.h>
+#include "sim.h"
+
+/**
+ * Host model of the Elechouse Voice Recognition V3 module.
+ *
+ * When someone says a trained word the module sends a recognition frame
+ * after a short delay:
+ *   0xAA len 0x0D 0x00 group record index sigLen [signature] 0x0A
+ * which EasyVR::recognize() unpacks and EasyVoice::readCommand() turns into
+ * the record number. Frames go out on the sketch's RX pin back to back at the
+ * port's baud rate through SoftwareSerial::startReceive(), so bytes arriving
+ * while the port isn't listening, the buffer is full or interrupts are off
+ * get dropped or mangled the way they would on the board.
+ *
+ * eg. VR3Model vr(VOICE_RX_PIN);
+ * eg. vr.attach();
+ * eg. vr.say(VR_CMD_AMMO_MODE_HE);
+ */
+class VR3Model : public sim::SerialDevice {
+public:
+  static const uint8_t FRAME_HEAD = 0xAA;
+  static const uint8_t FRAME_END = 0x0A;
+  static const uint8_t FRAME_CMD_VR = 0x0D;
+  static const uint8_t GROUP_NONE = 0xFF;
+
+  struct Stats {
+    unsigned long frames;
+    unsigned long bytes;
+    unsigned long commandBytes;  // sent to the module by the sketch
+  };
+
+  VR3Model(uint8_t rxPin);
+
+  /** Connect to the firmware's port with the given RX pin. Returns false if there is none. */
+  bool attach();
+
+  /** End of a spoken word until the frame starts going out. */
+  void setRecognizeMillis(unsigned long ms) { _recognizeMillis = ms; }
+
+  /**
+   * A trained word ends now (or at atMicros). Returns the time the last byte
+   * of the recognition frame is on the wire.
+   */
+  unsigned long long say(uint8_t record);
+  unsigned long long sayAt(unsigned long long atMicros, uint8_t record);
+
+  /** Send any frame: head, length, cmd, data, end. Returns when it is on the wire. */
+  unsigned long long sendFrameAt(unsigned long long atMicros, uint8_t cmd, const uint8_t *data, uint8_t len);
+
+  void receive(uint8_t b);
+
+  const Stats &stats() const { return _stats; }
+
+private:
+  uint8_t _rxPin;
+  SoftwareSerial *_port = 0;
+  unsigned long _recognizeMillis = 100;
+  unsigned long long _lineFree = 0;  // when the last frame is off the wire
+  Stats _stats = {};
+};
+
+#endif
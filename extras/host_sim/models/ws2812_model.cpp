@@ -0,0 +1,57 @@
+#include <string.h>
+
+#include <Arduino.h>
+
+#include "ws2812_model.h"
+
+WS2812Model::WS2812Model(uint8_t pin) : _pin(pin) {
+  memset(_wire, 0, sizeof(_wire));
+  memset(&_total, 0, sizeof(_total));
+  memset(&_lastFrame, 0, sizeof(_lastFrame));
+}
+
+void WS2812Model::attach() {
+  sim::addLedListener(this);
+  sim::addInterruptListener(this);
+}
+
+void WS2812Model::frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness) {
+  if (pin != _pin) return;
+  if (count > MAX_LEDS) count = MAX_LEDS;
+  _count = count;
+  // EOrder holds the source channel of each wire byte as octal digits, eg. GRB = 0102
+  uint8_t channel[3] = {(uint8_t)((order >> 6) & 3), (uint8_t)((order >> 3) & 3), (uint8_t)(order & 3)};
+  for (int i = 0; i < count; i++) {
+    for (int b = 0; b < 3; b++) {
+      _wire[i * 3 + b] = ((uint16_t)rgb[i * 3 + channel[b]] * (1 + brightness)) >> 8;
+    }
+  }
+  memset(&_lastFrame, 0, sizeof(_lastFrame));
+  _lastFrame.frames = 1;
+  _lastFrame.wireBytes = count * 3;
+  _total.frames++;
+  _total.wireBytes += count * 3;
+  _framePending = true;
+}
+
+void WS2812Model::interruptsBlocked(unsigned long long startMicros, unsigned long micros) {
+  if (!_framePending) return;
+  _framePending = false;
+  _lastFrame.blackoutMicros = micros;
+  _lastFrame.longestBlackoutMicros = micros;
+  _total.blackoutMicros += micros;
+  if (micros > _total.longestBlackoutMicros) _total.longestBlackoutMicros = micros;
+}
+
+uint32_t WS2812Model::color(int i) const {
+  if (i < 0 || i >= _count) return 0;
+  const uint8_t *p = &_wire[i * 3];
+  return ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 8) | p[2];
+}
+
+bool WS2812Model::lit() const {
+  for (int i = 0; i < _count * 3; i++) {
+    if (_wire[i]) return true;
+  }
+  return false;
+}
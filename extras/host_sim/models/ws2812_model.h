@@ -0,0 +1,68 @@
+#ifndef ws2812_model_h
+#define ws2812_model_h
+
+#include <stdint.h>
+
+#include "sim.h"
+
+/**
+ * Host model of a WS2812 strip on the end of FastLED's AVR clockless output.
+ *
+ * Every frame FastLED pushes to the model's pin is turned into what goes down
+ * the wire: channels reordered for the strip's EOrder and scaled by the show
+ * brightness (without FastLED's temporal dithering). The strip reads the wire
+ * as green, red, blue, so color() shows what each pixel lights up as.
+ *
+ * The FastLED shim clocks a frame out with interrupts off, as
+ * clockless_trinket.h does between cli() and sei(). The model claims the
+ * blackout that carries each of its frames, which is the window in which
+ * SoftwareSerial can't see a start bit from the DFPlayer or the voice module.
+ *
+ * eg. WS2812Model strip(FIRE_LED_PIN);
+ * eg. strip.attach();
+ * eg. ... run the firmware ...
+ * eg. strip.total().blackoutMicros;
+ */
+class WS2812Model : public sim::LedListener, public sim::InterruptListener {
+public:
+  static const int MAX_LEDS = 64;
+
+  /**
+   * Frames and interrupt blackouts, either for one frame or since the model
+   * was attached.
+   */
+  struct Stats {
+    unsigned long frames;
+    unsigned long wireBytes;
+    unsigned long long blackoutMicros;
+    unsigned long longestBlackoutMicros;
+  };
+
+  WS2812Model(uint8_t pin);
+
+  /** Start listening for frames and blackouts. */
+  void attach();
+
+  void frameShown(uint8_t pin, const uint8_t *rgb, int count, uint8_t order, uint8_t brightness);
+  void interruptsBlocked(unsigned long long startMicros, unsigned long micros);
+
+  int count() const { return _count; }
+  /** Color the pixel shows, 0xRRGGBB. */
+  uint32_t color(int i) const;
+  /** True when any pixel is lit. */
+  bool lit() const;
+
+  const Stats &total() const { return _total; }
+  const Stats &lastFrame() const { return _lastFrame; }
+
+private:
+  uint8_t _pin;
+  uint8_t _wire[MAX_LEDS * 3];  // bytes in the order they are clocked out
+  int _count = 0;
+  bool _framePending = false;   // frame shown, its blackout not ended yet
+
+  Stats _total;
+  Stats _lastFrame;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "recording.h"
+
+#include <stdio.h>
+
+#include <Arduino.h>
+#include "config.h"
+
+bool readRecording(const char *path, std::vector<RecordedInput> &inputs) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  unsigned long long wraps = 0, first = ~0ULL;
+  unsigned long last = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    unsigned id = 0;
+    unsigned long micros = 0;
+    int arg = -1;
+    if (sscanf(line, "~I%u %lu %d", &id, &micros, &arg) != 3) continue;
+    if (id != TRACE_BUTTON_DOWN && id != TRACE_BUTTON_UP && id != TRACE_VOICE_COMMAND) continue;
+    // micros() is 32 bits on the Nano
+    if (micros < last && last - micros > 0x80000000UL) wraps += 0x100000000ULL;
+    last = micros;
+    unsigned long long at = wraps + micros;
+    if (first == ~0ULL) first = at;
+    RecordedInput e;
+    e.at = at - first;
+    e.id = id;
+    e.arg = arg;
+    inputs.push_back(e);
+  }
+  fclose(f);
+  return true;
+}
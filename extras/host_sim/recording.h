@@ -0,0 +1,29 @@
+#ifndef recording_h
+#define recording_h
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * One input event from a recorded session, see the TRACE Macros in config.h:
+ * a button on pin arg going down (TRACE_BUTTON_DOWN) or up (TRACE_BUTTON_UP),
+ * or voice record arg being acted on (TRACE_VOICE_COMMAND).
+ */
+struct RecordedInput {
+  unsigned long long at;  // recorded time in us, from the first event
+  uint8_t id;
+  int arg;
+};
+
+/**
+ * Reads the input lines from the debug log of a firmware built with
+ * ENABLE_DEBUG and ENABLE_RECORD (or ENABLE_TRACE), skipping everything else.
+ * micros() wrapping at 32 bits is undone. Returns false if the file can't be
+ * read.
+ *
+ * eg. std::vector<RecordedInput> inputs;
+ * eg. readRecording("recordings/trigger_mash.log", inputs);
+ */
+bool readRecording(const char *path, std::vector<RecordedInput> &inputs);
+
+#endif
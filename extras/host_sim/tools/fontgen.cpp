@@ -0,0 +1,231 @@
+/**
+ * Generates stand-in U8g2 fonts for the host simulator.
+ *
+ * The bundled U8g2 copy ships without u8g2_fonts.c, so the helvB fonts used
+ * by EasyOLED are not available to a host build. This tool converts the
+ * bitmap fonts that are bundled (u8x8_fonts.c) into the U8g2 run-length
+ * format under the helvB names. Glyph shapes differ from Helvetica, but the
+ * render path through u8g2_DrawGlyph is the same one the firmware runs.
+ *
+ * When a real u8g2_fonts.c is available, point the build at it with
+ * -DU8G2_FONTS_SOURCE=<path> and this tool is not used.
+ *
+ * Usage: fontgen <output.c>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include "clib/u8x8.h"
+
+namespace {
+
+struct Glyph {
+  uint8_t encoding;
+  int w, h;      // bounding box
+  int x, y;      // offset from the cursor, y is bottom of box relative to the baseline
+  int dx;        // advance
+  std::vector<uint8_t> pixels;  // w * h, row major
+};
+
+/** LSB-first bit writer matching u8g2_font_decode_get_unsigned_bits(). */
+class BitWriter {
+public:
+  void put(unsigned value, int cnt) {
+    for (int i = 0; i < cnt; i++) {
+      if (_bit == 0) _bytes.push_back(0);
+      if (value & (1u << i)) _bytes.back() |= (1u << _bit);
+      _bit = (_bit + 1) & 7;
+    }
+  }
+  void putSigned(int value, int cnt) {
+    put((unsigned)(value + (1 << (cnt - 1))), cnt);
+  }
+  const std::vector<uint8_t> &bytes() const { return _bytes; }
+
+private:
+  std::vector<uint8_t> _bytes;
+  int _bit = 0;
+};
+
+const int BITS_PER_0 = 4;
+const int BITS_PER_1 = 4;
+const int BITS_PER_W = 5;
+const int BITS_PER_H = 6;
+const int BITS_PER_X = 5;
+const int BITS_PER_Y = 5;
+const int BITS_PER_D = 6;
+
+/** Read one pixel of a u8x8 glyph: tiles are row major, bytes are columns, LSB on top. */
+bool u8x8Pixel(const uint8_t *font, uint8_t encoding, int px, int py) {
+  uint8_t first = font[0], last = font[1], tw = font[2], th = font[3];
+  if (encoding < first || encoding > last) return false;
+  int tile = (py / 8) * tw + (px / 8);
+  size_t offset = 4 + ((size_t)(encoding - first) * tw * th + tile) * 8 + (px % 8);
+  return (font[offset] >> (py % 8)) & 1;
+}
+
+/** Row index just below the lowest set pixel of a glyph, or -1 if empty. */
+int glyphBottom(const uint8_t *font, uint8_t encoding) {
+  int cw = font[2] * 8, ch = font[3] * 8;
+  for (int py = ch - 1; py >= 0; py--)
+    for (int px = 0; px < cw; px++)
+      if (u8x8Pixel(font, encoding, px, py)) return py + 1;
+  return -1;
+}
+
+Glyph convert(const uint8_t *font, uint8_t encoding, int baseline) {
+  int cw = font[2] * 8, ch = font[3] * 8;
+  int x0 = cw, y0 = ch, x1 = -1, y1 = -1;
+  for (int py = 0; py < ch; py++) {
+    for (int px = 0; px < cw; px++) {
+      if (u8x8Pixel(font, encoding, px, py)) {
+        if (px < x0) x0 = px;
+        if (px > x1) x1 = px;
+        if (py < y0) y0 = py;
+        if (py > y1) y1 = py;
+      }
+    }
+  }
+  Glyph g;
+  g.encoding = encoding;
+  // the u8x8 cells leave a column of spacing on the right, keep the advance at cell width
+  g.dx = cw;
+  if (x1 < 0) {
+    g.w = g.h = g.x = g.y = 0;
+    return g;
+  }
+  g.w = x1 - x0 + 1;
+  g.h = y1 - y0 + 1;
+  g.x = x0;
+  g.y = baseline - (y1 + 1);
+  for (int py = y0; py <= y1; py++)
+    for (int px = x0; px <= x1; px++)
+      g.pixels.push_back(u8x8Pixel(font, encoding, px, py) ? 1 : 0);
+  return g;
+}
+
+std::vector<uint8_t> encodeGlyph(const Glyph &g) {
+  BitWriter bw;
+  bw.put(g.w, BITS_PER_W);
+  bw.put(g.h, BITS_PER_H);
+  bw.putSigned(g.x, BITS_PER_X);
+  bw.putSigned(g.y, BITS_PER_Y);
+  bw.putSigned(g.dx, BITS_PER_D);
+  if (g.w > 0) {
+    const int max0 = (1 << BITS_PER_0) - 1, max1 = (1 << BITS_PER_1) - 1;
+    size_t i = 0, n = g.pixels.size();
+    while (i < n) {
+      int a = 0, b = 0;
+      while (i < n && g.pixels[i] == 0 && a < max0) { a++; i++; }
+      if (!(i < n && g.pixels[i] == 0)) {
+        while (i < n && g.pixels[i] == 1 && b < max1) { b++; i++; }
+      }
+      bw.put(a, BITS_PER_0);
+      bw.put(b, BITS_PER_1);
+      bw.put(0, 1);  // no repeat
+    }
+  }
+  std::vector<uint8_t> out;
+  out.push_back(g.encoding);
+  out.push_back(0);  // size, patched below
+  out.insert(out.end(), bw.bytes().begin(), bw.bytes().end());
+  out[1] = (uint8_t)out.size();
+  return out;
+}
+
+std::vector<uint8_t> buildFont(const uint8_t *font) {
+  int baseline = glyphBottom(font, 'A');
+  int descent = glyphBottom(font, 'g') - baseline;
+
+  std::vector<Glyph> glyphs;
+  for (int e = 32; e < 127; e++) glyphs.push_back(convert(font, (uint8_t)e, baseline));
+
+  int maxW = 0, maxH = 0, minX = 0, minY = 0;
+  for (const Glyph &g : glyphs) {
+    if (g.w > maxW) maxW = g.w;
+    if (g.h > maxH) maxH = g.h;
+    if (g.x < minX) minX = g.x;
+    if (g.y < minY) minY = g.y;
+  }
+
+  std::vector<uint8_t> body;
+  uint16_t posA = 0, posa = 0;
+  for (const Glyph &g : glyphs) {
+    if (g.encoding == 'A') posA = (uint16_t)body.size();
+    if (g.encoding == 'a') posa = (uint16_t)body.size();
+    std::vector<uint8_t> enc = encodeGlyph(g);
+    body.insert(body.end(), enc.begin(), enc.end());
+  }
+  body.push_back(0);  // end of the 8 bit glyph list
+  body.push_back(0);
+  uint16_t posUnicode = (uint16_t)body.size();
+  // empty unicode jump table: offset 4, encoding 0xffff, then an end marker
+  const uint8_t unicode[] = { 0x00, 0x04, 0xff, 0xff, 0x00, 0x00 };
+  body.insert(body.end(), unicode, unicode + sizeof(unicode));
+
+  std::vector<uint8_t> out;
+  out.push_back((uint8_t)glyphs.size());
+  out.push_back(0);  // bbx mode: proportional
+  out.push_back(BITS_PER_0);
+  out.push_back(BITS_PER_1);
+  out.push_back(BITS_PER_W);
+  out.push_back(BITS_PER_H);
+  out.push_back(BITS_PER_X);
+  out.push_back(BITS_PER_Y);
+  out.push_back(BITS_PER_D);
+  out.push_back((uint8_t)maxW);
+  out.push_back((uint8_t)maxH);
+  out.push_back((uint8_t)(int8_t)minX);
+  out.push_back((uint8_t)(int8_t)minY);
+  out.push_back((uint8_t)baseline);               // ascent of 'A'
+  out.push_back((uint8_t)(int8_t)(-descent));     // descent of 'g'
+  out.push_back((uint8_t)baseline);
+  out.push_back((uint8_t)(int8_t)(-descent));
+  out.push_back(posA >> 8);
+  out.push_back(posA & 0xff);
+  out.push_back(posa >> 8);
+  out.push_back(posa & 0xff);
+  out.push_back(posUnicode >> 8);
+  out.push_back(posUnicode & 0xff);
+  out.insert(out.end(), body.begin(), body.end());
+  return out;
+}
+
+void writeFont(FILE *f, const char *name, const char *source, const std::vector<uint8_t> &data) {
+  fprintf(f, "/* stand-in for %s, converted from %s */\n", name, source);
+  fprintf(f, "const uint8_t %s[%u] U8G2_FONT_SECTION(\"%s\") = {", name, (unsigned)data.size(), name);
+  for (size_t i = 0; i < data.size(); i++) {
+    if (i % 16 == 0) fprintf(f, "\n  ");
+    fprintf(f, "0x%02x,", data[i]);
+  }
+  fprintf(f, "\n};\n\n");
+}
+
+}  // namespace
+
+extern "C" {
+extern const uint8_t u8x8_font_7x14B_1x2_r[];
+extern const uint8_t u8x8_font_8x13B_1x2_r[];
+extern const uint8_t u8x8_font_courB18_2x3_r[];
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+    return 2;
+  }
+  FILE *f = fopen(argv[1], "w");
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+  fprintf(f, "/* Generated by fontgen - do not edit. */\n#include \"clib/u8g2.h\"\n\n");
+  writeFont(f, "u8g2_font_helvB12_tr", "u8x8_font_7x14B_1x2_r", buildFont(u8x8_font_7x14B_1x2_r));
+  writeFont(f, "u8g2_font_helvB14_tr", "u8x8_font_8x13B_1x2_r", buildFont(u8x8_font_8x13B_1x2_r));
+  writeFont(f, "u8g2_font_helvB18_tr", "u8x8_font_courB18_2x3_r", buildFont(u8x8_font_courB18_2x3_r));
+  fclose(f);
+  return 0;
+}
@@ -0,0 +1,253 @@
+/**
+ * Renders the EasyOLED labels in easyoledlabels.h, the text and the drawn
+ * battery and grid, into easyoledlabelbits.h, for ENABLE_OLED_LABELS and
+ * ENABLE_OLED_SHAPES.
+ *
+ * Each label is drawn with U8g2, in its font and at its place on the screen,
+ * into a full SH1122 buffer set up the way EasyOLED sets it up (U8G2_R2).
+ * What is written out are the buffer bytes of the lines the label covers,
+ * from its first to its last byte column. The SH1122 buffer is packed
+ * horizontally, a byte is 8 pixels of one line with the LSB on the right
+ * (u8g2_ll_hvline_horizontal_right_lsb), and a page is 8 lines per tile
+ * row, so the firmware only has to OR the bytes in.
+ *
+ * It also makes the atlas of the ammo counters, for ENABLE_OLED_COUNTERS: each digit and each suffix
+ * drawn on its own, cut to its pixels and left aligned, for the firmware to
+ * shift into place. Before writing anything it checks that every count up
+ * to 99, put together from the atlas, is what print() draws, so a font
+ * whose glyphs overlap or whose digits aren't all as wide is turned down.
+ *
+ * Run it against the real U8g2 fonts (U8G2_FONTS_SOURCE) for the header in
+ * dredd-lawgiver/; the host build makes its own with whatever fonts it has.
+ *
+ * Usage: labelgen <easyoledlabelbits.h>
+ */
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "config.h"
+#include "easyoledlabels.h"
+
+namespace {
+
+struct Label {
+  const char *name;
+  int x, width, line, lines;  // in bytes across, in pixel lines down
+  std::vector<uint8_t> bits;
+};
+
+/** Keep the part of the buffer the label drew on. */
+Label crop(const char *name, const uint8_t *buf, int stride, int height) {
+  Label label = {name, 0, 0, 0, 0, {}};
+  int left = stride, right = -1, top = height, bottom = -1;
+  for (int line = 0; line < height; line++) {
+    for (int x = 0; x < stride; x++) {
+      if (!buf[line * stride + x]) continue;
+      if (x < left) left = x;
+      if (x > right) right = x;
+      if (line < top) top = line;
+      if (line > bottom) bottom = line;
+    }
+  }
+  if (right < 0) return label;
+  label.x = left;
+  label.width = right - left + 1;
+  label.line = top;
+  label.lines = bottom - top + 1;
+  for (int line = top; line <= bottom; line++)
+    label.bits.insert(label.bits.end(), buf + line * stride + left, buf + line * stride + right + 1);
+  return label;
+}
+
+/** A digit or a suffix of the counter atlas, in display columns and lines. */
+struct Glyph {
+  std::string name;
+  int left, width, line, lines;  // left is from the cursor, on the screen
+  std::vector<uint8_t> bits;     // (width + 7) / 8 bytes a line, MSB first
+};
+
+bool pixel(const uint8_t *buf, int stride, int column, int line) {
+  return buf[line * stride + (column >> 3)] & (0x80 >> (column & 7));
+}
+
+/** Cut what was drawn with the cursor at x down to its pixels. */
+Glyph cropGlyph(const std::string &name, const uint8_t *buf, int stride, int height, int x) {
+  Glyph glyph = {name, 0, 0, 0, 0, {}};
+  int left = stride * 8, right = -1, top = height, bottom = -1;
+  for (int line = 0; line < height; line++) {
+    for (int column = 0; column < stride * 8; column++) {
+      if (!pixel(buf, stride, column, line)) continue;
+      if (column < left) left = column;
+      if (column > right) right = column;
+      if (line < top) top = line;
+      if (line > bottom) bottom = line;
+    }
+  }
+  if (right < 0) return glyph;
+  // upside down, the rightmost column is the leftmost pixel on the screen
+  glyph.left = (stride * 8 - 1 - right) - x;
+  glyph.width = right - left + 1;
+  glyph.line = top;
+  glyph.lines = bottom - top + 1;
+  int bytes = (glyph.width + 7) / 8;
+  for (int line = top; line <= bottom; line++) {
+    std::vector<uint8_t> row(bytes, 0);
+    for (int i = 0; i < glyph.width; i++)
+      if (pixel(buf, stride, left + i, line)) row[i >> 3] |= 0x80 >> (i & 7);
+    glyph.bits.insert(glyph.bits.end(), row.begin(), row.end());
+  }
+  return glyph;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <easyoledlabelbits.h>\n", argv[0]);
+    return 2;
+  }
+  // the bus is never used, only the buffer
+  U8G2_SH1122_256X64_F_4W_SW_SPI u8g2(U8G2_R2, 0, 0, 0, 0, 0);
+  std::vector<Label> labels;
+#define OLED_LABEL_RENDER(id, font, x, y, text) \
+  u8g2.clearBuffer(); \
+  u8g2.setFont(font); \
+  u8g2.setCursor(x, y); \
+  u8g2.print(text); \
+  labels.push_back(crop(#id, u8g2.getBufferPtr(), u8g2.getBufferTileWidth(), u8g2.getBufferTileHeight() * 8));
+  OLED_LABELS(OLED_LABEL_RENDER)
+#undef OLED_LABEL_RENDER
+#define OLED_SHAPE_RENDER(id, draw) \
+  u8g2.clearBuffer(); \
+  draw(u8g2); \
+  labels.push_back(crop(#id, u8g2.getBufferPtr(), u8g2.getBufferTileWidth(), u8g2.getBufferTileHeight() * 8));
+  OLED_SHAPES(OLED_SHAPE_RENDER)
+#undef OLED_SHAPE_RENDER
+
+  // the counter atlas, drawn away from the edges
+  const int x = 64;
+  const int stride = u8g2.getBufferTileWidth();
+  const int height = u8g2.getBufferTileHeight() * 8;
+  const char *suffixes[] = OLED_COUNTER_SUFFIXES;
+  std::vector<Glyph> atlas;
+  int advance = 0;
+  for (int i = 0; i < OLED_COUNTER_SUFFIX + 4; i++) {
+    std::string text = i < OLED_COUNTER_SUFFIX ? std::string(1, '0' + i) : suffixes[i - OLED_COUNTER_SUFFIX];
+    u8g2.clearBuffer();
+    u8g2.setFont(OLED_COUNTER_FONT);
+    u8g2.setCursor(x, OLED_COUNTER_Y);
+    u8g2.print(text.c_str());
+    atlas.push_back(cropGlyph("'" + text + "'", u8g2.getBufferPtr(), stride, height, x));
+    int width = u8g2.tx - x;
+    if (i == 0) {
+      advance = width;
+    } else if (i < OLED_COUNTER_SUFFIX && width != advance) {
+      fprintf(stderr, "digit %c is %d wide and 0 is %d, the counters need even digits\n", '0' + i, width, advance);
+      return 1;
+    }
+  }
+  u8g2.setCursor(x, OLED_COUNTER_Y);
+  u8g2.print(" ");
+  int space = u8g2.tx - x;
+
+  // every count and suffix, at every bit offset, through print() and from the atlas
+  std::vector<uint8_t> printed(stride * height), composed(stride * height);
+  for (int count = 0; count < 100; count++) {
+    for (int suffix = 0; suffix < 4; suffix++) {
+      for (int at = 40; at < 48; at++) {
+        char text[10];
+        snprintf(text, sizeof(text), "%s%d%s", count >= 10 ? " " : "", count, suffixes[suffix]);
+        u8g2.clearBuffer();
+        u8g2.setFont(OLED_COUNTER_FONT);
+        u8g2.setCursor(at, OLED_COUNTER_Y);
+        u8g2.print(text);
+        memcpy(printed.data(), u8g2.getBufferPtr(), printed.size());
+
+        std::fill(composed.begin(), composed.end(), 0);
+        int cursor = at + (count >= 10 ? space : 0);
+        std::string parts = std::to_string(count);
+        for (size_t i = 0; i <= parts.size(); i++) {
+          std::string part = i < parts.size() ? parts.substr(i, 1) : suffixes[suffix];
+          u8g2.clearBuffer();
+          u8g2.setCursor(cursor, OLED_COUNTER_Y);
+          u8g2.print(part.c_str());
+          for (size_t b = 0; b < composed.size(); b++) composed[b] |= u8g2.getBufferPtr()[b];
+          cursor += advance;
+        }
+        if (printed != composed) {
+          fprintf(stderr, "\"%s\" at %d comes out different from the atlas\n", text, at);
+          return 1;
+        }
+      }
+    }
+  }
+
+  FILE *f = fopen(argv[1], "w");
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+  fprintf(f, "// Generated by labelgen from easyoledlabels.h - do not edit.\n");
+  fprintf(f, "#ifndef easyoledlabelbits_h\n#define easyoledlabelbits_h\n\n");
+  fprintf(f, "const uint8_t oledLabelBits[] PROGMEM = {");
+  for (const Label &label : labels) {
+    fprintf(f, "\n  // %s", label.name);
+    for (size_t i = 0; i < label.bits.size(); i++) {
+      if (i % 16 == 0) fprintf(f, "\n  ");
+      fprintf(f, "0x%02x,", label.bits[i]);
+    }
+  }
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "// where each label starts in oledLabelBits\n");
+  fprintf(f, "const uint16_t oledLabelOffset[] PROGMEM = {\n");
+  unsigned offset = 0;
+  for (const Label &label : labels) {
+    fprintf(f, "  %u,  // %s\n", offset, label.name);
+    offset += label.bits.size();
+  }
+  fprintf(f, "};\n\n");
+
+  fprintf(f, "// first byte column, byte columns, first line and lines of each label\n");
+  fprintf(f, "const uint8_t oledLabelBox[][4] PROGMEM = {\n");
+  for (const Label &label : labels)
+    fprintf(f, "  {%d, %d, %d, %d},  // %s\n", label.x, label.width, label.line, label.lines, label.name);
+  fprintf(f, "};\n\n");
+  fprintf(f, "static_assert(sizeof(oledLabelBox) / sizeof(oledLabelBox[0]) == OLED_LABEL_COUNT,\n");
+  fprintf(f, "              \"easyoledlabels.h changed, run labelgen again\");\n\n");
+
+  fprintf(f, "// the counters: cursor advance of a digit and of a space\n");
+  fprintf(f, "#define OLED_COUNTER_ADVANCE    %d\n", advance);
+  fprintf(f, "#define OLED_COUNTER_SPACE      %d\n\n", space);
+  fprintf(f, "const uint8_t oledCounterBits[] PROGMEM = {");
+  unsigned atlasBytes = 0;
+  for (const Glyph &glyph : atlas) {
+    fprintf(f, "\n  // %s", glyph.name.c_str());
+    for (size_t i = 0; i < glyph.bits.size(); i++) {
+      if (i % 16 == 0) fprintf(f, "\n  ");
+      fprintf(f, "0x%02x,", glyph.bits[i]);
+    }
+  }
+  fprintf(f, "\n};\n\n");
+  fprintf(f, "const uint16_t oledCounterOffset[] PROGMEM = {\n");
+  for (const Glyph &glyph : atlas) {
+    fprintf(f, "  %u,  // %s\n", atlasBytes, glyph.name.c_str());
+    atlasBytes += glyph.bits.size();
+  }
+  fprintf(f, "};\n\n");
+  fprintf(f, "// left edge from the cursor, pixels across, first line and lines of each glyph\n");
+  fprintf(f, "const int8_t oledCounterBox[][4] PROGMEM = {\n");
+  for (const Glyph &glyph : atlas)
+    fprintf(f, "  {%d, %d, %d, %d},  // %s\n", glyph.left, glyph.width, glyph.line, glyph.lines, glyph.name.c_str());
+  fprintf(f, "};\n\n");
+  fprintf(f, "#endif\n");
+  fclose(f);
+  printf("%u label bytes, %u with the tables\n", offset, (unsigned)(offset + labels.size() * 6));
+  printf("%u counter atlas bytes, %u with the tables\n", atlasBytes, (unsigned)(atlasBytes + atlas.size() * 6));
+  return 0;
+}
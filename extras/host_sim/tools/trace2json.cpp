@@ -0,0 +1,192 @@
+/**
+ * Converts a Lawgiver debug log into a Chrome trace.
+ *
+ * Reads what a firmware built with ENABLE_DEBUG and ENABLE_TRACE prints on
+ * its debug port, from the board's serial monitor or from lawgiver_trace,
+ * and writes the Trace Event JSON that chrome://tracing and Perfetto
+ * (ui.perfetto.dev) open. Trace lines look like:
+ *   ~B3 1234567      begin of event 3 at micros() 1234567
+ *   ~E3 1236012      end of event 3
+ *   ~I7 1240000 8    instant event 7, argument 8
+ * (see the TRACE Macros in config.h). The firmware runs on a single thread,
+ * so everything goes on one track and nests: a main loop pass holds the
+ * screen redraw, which holds its page flushes. Any other line is a DBG
+ * message and shows up as an instant at the time of the last event.
+ *
+ * micros() wraps every 71 minutes, the timestamps are unwrapped on the way.
+ * A summary of count, total and longest time per event goes to stderr.
+ *
+ * Usage: trace2json [log [trace.json]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct EventType {
+  const char *name;
+  const char *category;
+  const char *argName;
+};
+
+// keep in step with the TRACE_* ids in config.h
+const EventType EVENT_TYPES[] = {
+    {"", "", ""},
+    {"mainLoop", "loop", ""},
+    {"EasyOLED::drawDisplay", "oled", ""},
+    {"u8g2.nextPage", "oled", ""},
+    {"FastLED.show", "led", ""},
+    {"audio command", "audio", ""},
+    {"EasyVR::recognize", "voice", ""},
+    {"button down", "button", "pin"},
+    {"button up", "button", "pin"},
+    {"voice command", "voice", "record"},
+};
+const unsigned EVENT_TYPE_CNT = sizeof(EVENT_TYPES) / sizeof(EVENT_TYPES[0]);
+
+struct Summary {
+  unsigned long count = 0;
+  unsigned long long total = 0;
+  unsigned long long max = 0;
+};
+
+std::string jsonString(const std::string &s) {
+  std::string out = "\"";
+  for (size_t i = 0; i < s.size(); i++) {
+    unsigned char c = s[i];
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+/** Writes the events as they come, comma separated. */
+class TraceWriter {
+public:
+  TraceWriter(FILE *f) : _f(f) {
+    fprintf(_f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(_f, "{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Lawgiver\"}}");
+    fprintf(_f, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"loop\"}}");
+  }
+  void event(char ph, const std::string &name, const char *cat, unsigned long long ts, const std::string &args) {
+    fprintf(_f, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":1,\"name\":%s,\"cat\":\"%s\",\"ts\":%llu", ph, jsonString(name).c_str(),
+            cat, ts);
+    if (ph == 'i') fprintf(_f, ",\"s\":\"t\"");
+    if (!args.empty()) fprintf(_f, ",\"args\":{%s}", args.c_str());
+    fprintf(_f, "}");
+  }
+  void close() { fprintf(_f, "\n]}\n"); }
+
+private:
+  FILE *_f;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc > 3) {
+    fprintf(stderr, "usage: %s [log [trace.json]]\n", argv[0]);
+    return 2;
+  }
+  FILE *in = stdin;
+  FILE *out = stdout;
+  if (argc > 1 && strcmp(argv[1], "-") != 0) {
+    in = fopen(argv[1], "r");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+  if (argc > 2) {
+    out = fopen(argv[2], "w");
+    if (!out) {
+      perror(argv[2]);
+      return 1;
+    }
+  }
+
+  TraceWriter trace(out);
+  std::map<unsigned, Summary> summary;
+  std::vector<std::pair<unsigned, unsigned long long> > open;
+  unsigned long long wraps = 0;
+  unsigned long last = 0;
+  unsigned long long now = 0;
+  unsigned long events = 0, messages = 0, unmatched = 0;
+
+  char line[512];
+  while (fgets(line, sizeof(line), in)) {
+    size_t len = strlen(line);
+    while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = 0;
+    if (!len) continue;
+
+    char ph = 0;
+    unsigned id = 0;
+    unsigned long micros = 0;
+    long arg = -1;
+    int fields = line[0] == '~' ? sscanf(line + 1, "%c%u %lu %ld", &ph, &id, &micros, &arg) : 0;
+    if (fields < 3 || (ph != 'B' && ph != 'E' && ph != 'I') || id == 0 || id >= EVENT_TYPE_CNT) {
+      trace.event('i', line, "debug", now, "");
+      messages++;
+      continue;
+    }
+
+    // micros() is 32 bits on the Nano
+    if (micros < last && last - micros > 0x80000000UL) wraps += 0x100000000ULL;
+    last = micros;
+    now = wraps + micros;
+    events++;
+
+    const EventType &type = EVENT_TYPES[id];
+    std::string args;
+    if (arg >= 0 && type.argName[0]) args = "\"" + std::string(type.argName) + "\":" + std::to_string(arg);
+    if (ph == 'B') {
+      trace.event('B', type.name, type.category, now, args);
+      open.push_back(std::make_pair(id, now));
+    } else if (ph == 'E') {
+      trace.event('E', type.name, type.category, now, args);
+      // close the event, dropping any left open inside it
+      while (!open.empty() && open.back().first != id) {
+        open.pop_back();
+        unmatched++;
+      }
+      if (open.empty()) {
+        unmatched++;
+        continue;
+      }
+      unsigned long long us = now - open.back().second;
+      open.pop_back();
+      Summary &s = summary[id];
+      s.count++;
+      s.total += us;
+      if (us > s.max) s.max = us;
+    } else {
+      trace.event('i', type.name, type.category, now, args);
+      summary[id].count++;
+    }
+  }
+  trace.close();
+  if (in != stdin) fclose(in);
+  if (out != stdout) fclose(out);
+
+  fprintf(stderr, "%lu events, %lu debug messages, %.1f ms\n", events, messages, now / 1000.0);
+  fprintf(stderr, "%-24s %8s %12s %10s\n", "event", "count", "total ms", "max ms");
+  for (std::map<unsigned, Summary>::const_iterator it = summary.begin(); it != summary.end(); ++it) {
+    const Summary &s = it->second;
+    fprintf(stderr, "%-24s %8lu %12.1f %10.1f\n", EVENT_TYPES[it->first].name, s.count, s.total / 1000.0,
+            s.max / 1000.0);
+  }
+  if (unmatched) fprintf(stderr, "unmatched events: %lu\n", unmatched);
+  return 0;
+}
@@ -100,18 +100,54 @@ static uint8_t *u8x8_sh1122_8to32(U8X8_UNUSED u8x8_t *u8x8, uint8_t *ptr)
 */
 
 
-static uint8_t u8x8_write_byte_to_16gr_device(u8x8_t *u8x8, uint8_t b)
+/* 4 pixel (one nibble) to 2 bytes of 4 bit gray, the high pixel goes first */
+static const uint8_t u8x8_sh1122_16gr_nibble[32] U8X8_PROGMEM = {
+  0x00, 0x00,
+  0x00, 0x0f,
+  0x00, 0xf0,
+  0x00, 0xff,
+  0x0f, 0x00,
+  0x0f, 0x0f,
+  0x0f, 0xf0,
+  0x0f, 0xff,
+  0xf0, 0x00,
+  0xf0, 0x0f,
+  0xf0, 0xf0,
+  0xf0, 0xff,
+  0xff, 0x00,
+  0xff, 0x0f,
+  0xff, 0xf0,
+  0xff, 0xff
+};
+
+/* source bytes expanded per data transfer, 4 gray bytes each on the stack */
+#define U8X8_SH1122_ROW_CHUNK 8
+
+/* expand cnt bytes of 1 bit pixels to 4 bit gray and send them, U8X8_SH1122_ROW_CHUNK bytes per data transfer */
+static uint8_t u8x8_write_row_to_16gr_device(u8x8_t *u8x8, uint8_t cnt, const uint8_t *ptr)
 {
-  static uint8_t buf[4];
-  static uint8_t map[4] = { 0, 0x00f, 0x0f0, 0x0ff };
-  buf [3] = map[b & 3];
-  b>>=2;
-  buf [2] = map[b & 3];
-  b>>=2;
-  buf [1] = map[b & 3];
-  b>>=2;
-  buf [0] = map[b & 3];
-  return u8x8_cad_SendData(u8x8, 4, buf);
+  uint8_t buf[4*U8X8_SH1122_ROW_CHUNK];
+  uint8_t *dest;
+  const uint8_t *map;
+  uint8_t i, n, b;
+  while( cnt > 0 )
+  {
+    n = cnt > U8X8_SH1122_ROW_CHUNK ? U8X8_SH1122_ROW_CHUNK : cnt;
+    dest = buf;
+    for( i = 0; i < n; i++ )
+    {
+      b = *ptr++;
+      map = u8x8_sh1122_16gr_nibble + ((b >> 4) << 1);
+      *dest++ = u8x8_pgm_read(map);
+      *dest++ = u8x8_pgm_read(map+1);
+      map = u8x8_sh1122_16gr_nibble + ((b & 15) << 1);
+      *dest++ = u8x8_pgm_read(map);
+      *dest++ = u8x8_pgm_read(map+1);
+    }
+    u8x8_cad_SendData(u8x8, n*4, buf);
+    cnt -= n;
+  }
+  return 1;
 }
 
 uint8_t u8x8_d_sh1122_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
@@ -164,12 +200,9 @@ uint8_t u8x8_d_sh1122_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
 	u8x8_cad_SendCmd(u8x8, 0x010 | (x >> 4) );	/* higher 3 bit */	  
 	c = ((u8x8_tile_t *)arg_ptr)->cnt;	/* number of tiles */
 
-	while (  c > 0 )
-	{
-	  u8x8_write_byte_to_16gr_device(u8x8, *ptr);
-	  c--;
-	  ptr++;
-	}
+	/* the pixel row in a few data transfers, 32 gray bytes each */
+	u8x8_write_row_to_16gr_device(u8x8, c, ptr);
+	ptr += c;
 	y++;
       }
 